@@ -0,0 +1,121 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "ofMain.h"
+#include "ofxPointer.h"
+
+
+// Count every heap allocation made while counting is enabled.
+static std::atomic<bool> isCounting(false);
+static std::atomic<std::size_t> allocationCount(0);
+
+
+void* operator new(std::size_t size)
+{
+    if (isCounting)
+        ++allocationCount;
+
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+
+/// \brief Count the allocations made by a function after a warm-up call.
+/// \param name The name to report.
+/// \param function The function to test.
+/// \returns true if the function did not allocate.
+template <typename Function>
+bool expectNoAllocations(const std::string& name, Function function)
+{
+    // The first call may grow the event's sample storage.
+    function(0);
+
+    allocationCount = 0;
+    isCounting = true;
+
+    for (std::size_t i = 1; i <= 1000; ++i)
+        function(i);
+
+    isCounting = false;
+
+    std::size_t count = allocationCount;
+
+    if (count == 0)
+    {
+        ofLogNotice("allocation_test") << "PASS " << name;
+        return true;
+    }
+
+    ofLogError("allocation_test") << "FAIL " << name << ": " << count << " allocations.";
+    return false;
+}
+
+
+int main()
+{
+    ofx::PointerEventArgs event;
+    ofx::PointerInputState inputState;
+    inputState.buttons = 1 << OF_MOUSE_BUTTON_1;
+
+    ofMouseEventArgs mouse(ofMouseEventArgs::Dragged, 0, 0, OF_MOUSE_BUTTON_1);
+
+    ofTouchEventArgs touch;
+    touch.type = ofTouchEventArgs::move;
+    touch.id = 1;
+    touch.width = 10;
+    touch.height = 10;
+    touch.pressure = 0.5;
+
+    bool passed = true;
+
+    passed &= expectNoAllocations("mouse", [&](std::size_t i) {
+        mouse.x = float(i);
+        ofx::PointerEventArgs::toPointerEventArgs(nullptr, mouse, event);
+    });
+
+    passed &= expectNoAllocations("mouse with input state", [&](std::size_t i) {
+        mouse.x = float(i);
+        ofx::PointerEventArgs::toPointerEventArgs(nullptr, mouse, inputState, event);
+    });
+
+    passed &= expectNoAllocations("touch", [&](std::size_t i) {
+        touch.x = float(i);
+        ofx::PointerEventArgs::toPointerEventArgs(nullptr, touch, event);
+    });
+
+    passed &= expectNoAllocations("touch with input state", [&](std::size_t i) {
+        touch.x = float(i);
+        ofx::PointerEventArgs::toPointerEventArgs(nullptr, touch, inputState, event);
+    });
+
+    // Alternate the device, so each conversion replaces the other's values.
+    passed &= expectNoAllocations("alternating mouse and touch", [&](std::size_t i) {
+        if (i % 2 == 0)
+            ofx::PointerEventArgs::toPointerEventArgs(nullptr, mouse, inputState, event);
+        else
+            ofx::PointerEventArgs::toPointerEventArgs(nullptr, touch, inputState, event);
+    });
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include <cstdlib>
+#include <random>
+#include "ofMain.h"
+#include "ofxPointer.h"
+
+
+/// \returns true if the batch result matches the scalar result.
+bool isClose(float batch, float scalar)
+{
+    // The batch kernel uses polynomial sin and cos, so allow float rounding.
+    return std::abs(batch - scalar) <= 1e-3f + 1e-5f * std::abs(scalar);
+}
+
+
+/// \brief Compare the batch kernel with PointShape::axisAlignedWidth/Height.
+/// \param shapeType The type of the shapes.
+/// \param size The number of shapes.
+/// \param generator The random number generator.
+/// \returns true if all sizes match.
+bool testBatch(ofx::PointShape::ShapeType shapeType,
+               std::size_t size,
+               std::mt19937& generator)
+{
+    std::uniform_real_distribution<float> axis(0, 200);
+    std::uniform_real_distribution<float> angle(-720, 720);
+
+    std::vector<float> widths(size);
+    std::vector<float> heights(size);
+    std::vector<float> anglesDeg(size);
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        widths[i] = axis(generator);
+        heights[i] = axis(generator);
+
+        // Mix in exact quarter turns, where sin or cos is zero.
+        anglesDeg[i] = i % 5 == 0 ? 90.0f * float(int(i % 9) - 4) : angle(generator);
+    }
+
+    std::vector<float> axisAlignedWidths(size);
+    std::vector<float> axisAlignedHeights(size);
+
+    ofx::PointShape::toAxisAlignedSize(shapeType,
+                                       widths.data(),
+                                       heights.data(),
+                                       anglesDeg.data(),
+                                       axisAlignedWidths.data(),
+                                       axisAlignedHeights.data(),
+                                       size);
+
+    bool passed = true;
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        ofx::PointShape shape(shapeType, widths[i], heights[i], 0, 0, anglesDeg[i]);
+
+        if (!isClose(axisAlignedWidths[i], shape.axisAlignedWidth())
+        ||  !isClose(axisAlignedHeights[i], shape.axisAlignedHeight()))
+        {
+            ofLogError("axis_aligned_size_test") << "FAIL shape " << i << " of " << size
+                << ": " << widths[i] << " x " << heights[i] << " at " << anglesDeg[i] << " degrees,"
+                << " batch " << axisAlignedWidths[i] << " x " << axisAlignedHeights[i] << ","
+                << " scalar " << shape.axisAlignedWidth() << " x " << shape.axisAlignedHeight();
+            passed = false;
+        }
+    }
+
+    return passed;
+}
+
+
+int main()
+{
+    std::mt19937 generator(1);
+    bool passed = true;
+
+    // Sizes that are not a multiple of 4 exercise the remainder lanes.
+    for (auto shapeType: { ofx::PointShape::ShapeType::ELLIPSE,
+                           ofx::PointShape::ShapeType::RECTANGLE })
+    {
+        for (std::size_t size = 0; size <= 67; ++size)
+            passed &= testBatch(shapeType, size, generator);
+
+        passed &= testBatch(shapeType, 10003, generator);
+    }
+
+    if (passed)
+        ofLogNotice("axis_aligned_size_test") << "PASS";
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,81 @@
+//
+// Copyright (c) 2019 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:	MIT
+//
+
+
+#include <cstdlib>
+#include "ofMain.h"
+#include "ofxPointer.h"
+
+
+/// \brief Adds every dispatched pointer event to a stroke.
+class StrokeRecorder
+{
+public:
+    void onPointerEvent(ofx::PointerEventArgs& e)
+    {
+        stroke.add(e);
+    }
+
+    ofx::PointerStroke stroke;
+
+};
+
+
+/// \brief Post a down and a move sample and check that both reach a stroke.
+/// \param isFrameBatchingEnabled True if frame batching should be enabled.
+/// \returns true if the stroke holds both samples.
+bool testPostedSamples(bool isFrameBatchingEnabled)
+{
+    ofx::PointerEvents events(nullptr);
+    events.setFrameBatchingEnabled(isFrameBatchingEnabled);
+
+    StrokeRecorder recorder;
+    ofAddListener(events.pointerEvent, &recorder, &StrokeRecorder::onPointerEvent);
+
+    ofx::PointerSample sample;
+    sample.pointerId = 1;
+    sample.deviceKind = ofx::PointerEventArgs::DeviceKind::PEN;
+    sample.buttons = 1 << OF_MOUSE_BUTTON_1;
+    sample.pressure = 0.5;
+
+    sample.eventKind = ofx::PointerEventArgs::EventKind::POINTER_DOWN;
+    sample.timestampMicros = 1000;
+    sample.position = { 10, 10 };
+    events.postPointerSample(sample);
+
+    sample.eventKind = ofx::PointerEventArgs::EventKind::POINTER_MOVE;
+    sample.timestampMicros = 2000;
+    sample.position = { 20, 10 };
+    events.postPointerSample(sample);
+
+    events.flush();
+
+    ofRemoveListener(events.pointerEvent, &recorder, &StrokeRecorder::onPointerEvent);
+
+    std::string name = isFrameBatchingEnabled ? "batched" : "unbatched";
+
+    if (recorder.stroke.committedSize() == 2 && recorder.stroke.length() == 10)
+    {
+        ofLogNotice("posted_sample_test") << "PASS " << name;
+        return true;
+    }
+
+    ofLogError("posted_sample_test") << "FAIL " << name << ": "
+                                     << recorder.stroke.committedSize()
+                                     << " committed samples.";
+    return false;
+}
+
+
+int main()
+{
+    bool passed = true;
+
+    passed &= testPostedSamples(false);
+    passed &= testPostedSamples(true);
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -8,9 +8,18 @@
 #pragma once
 
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iterator>
+#include <limits>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
 #include "json.hpp"
 #include "ofEvents.h"
 #include "ofColor.h"
@@ -27,6 +36,109 @@ namespace ofx {
 class PointShape;
 class Point;
 class PointerEventArgs;
+struct PointerSample;
+
+
+/// \brief A non-owning, read-only view of a contiguous sequence of elements.
+///
+/// A ConstSpan is only valid as long as the storage it refers to.
+///
+/// \tparam T The element type.
+template <typename T>
+class ConstSpan
+{
+public:
+    /// \brief Create an empty ConstSpan.
+    ConstSpan()
+    {
+    }
+
+    /// \brief Create a ConstSpan with the given data.
+    /// \param data A pointer to the first element.
+    /// \param size The number of elements.
+    ConstSpan(const T* data, std::size_t size): _data(data), _size(size)
+    {
+    }
+
+    /// \brief Create a ConstSpan viewing the contents of a std::vector.
+    /// \param elements The elements to view.
+    ConstSpan(const std::vector<T>& elements):
+        ConstSpan(elements.data(), elements.size())
+    {
+    }
+
+    /// \returns a copy of the elements as a std::vector.
+    operator std::vector<T>() const
+    {
+        return std::vector<T>(begin(), end());
+    }
+
+    /// \returns a pointer to the first element.
+    const T* data() const
+    {
+        return _data;
+    }
+
+    /// \returns the number of elements.
+    std::size_t size() const
+    {
+        return _size;
+    }
+
+    /// \returns true if size() == 0.
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    /// \returns an iterator to the first element.
+    const T* begin() const
+    {
+        return _data;
+    }
+
+    /// \returns an iterator past the last element.
+    const T* end() const
+    {
+        return _data + _size;
+    }
+
+    /// \returns the first element. The span must not be empty.
+    const T& front() const
+    {
+        return _data[0];
+    }
+
+    /// \returns the last element. The span must not be empty.
+    const T& back() const
+    {
+        return _data[_size - 1];
+    }
+
+    /// \returns the element at index i. No bounds checking is performed.
+    const T& operator [] (std::size_t i) const
+    {
+        return _data[i];
+    }
+
+private:
+    /// \brief A pointer to the first element.
+    const T* _data = nullptr;
+
+    /// \brief The number of elements.
+    std::size_t _size = 0;
+
+};
+
+
+template <typename T>
+inline void to_json(nlohmann::json& j, const ConstSpan<T>& v)
+{
+    j = nlohmann::json::array();
+
+    for (const auto& e: v)
+        j.push_back(e);
+}
 
 
 /// \brief A base class describing the basic components of event arguments.
@@ -57,7 +169,7 @@ public:
     const void* eventSource() const;
 
     /// \returns the event type.
-    std::string eventType() const;
+    const std::string& eventType() const;
 
     /// \returns the timestamp of this event in milliseconds.
     uint64_t timestampMillis() const;
@@ -68,16 +180,64 @@ public:
     /// \returns the optional event detail.
     uint64_t detail() const;
 
+    /// \brief Get the current time of the event clock.
+    ///
+    /// All timestamps created by ofxPointer use this clock. Its epoch is the
+    /// app start, so it matches ofGetElapsedTimeMicros() until
+    /// ofResetElapsedTimeCounter() is called. Unlike ofGetElapsedTimeMicros()
+    /// it is monotonic, is not affected by ofResetElapsedTimeCounter() and
+    /// may be read from any thread, so timestamps taken on input threads can
+    /// be compared with timestamps taken on the main thread.
+    ///
+    /// \returns the microseconds elapsed since the app start.
+    static uint64_t nowMicros();
+
+    /// \brief Convert a steady clock time point to an event clock timestamp.
+    /// \param time The time point to convert. It must not be earlier than
+    ///        the app start.
+    /// \returns the matching timestamp in microseconds.
+    static uint64_t toTimestampMicros(std::chrono::steady_clock::time_point time);
+
     /// \brief An unknown event type.
     static const std::string EVENT_TYPE_UNKNOWN;
 
+protected:
+    /// \brief Create a EventArgs with an interned event type.
+    /// \param eventSource The source of the event.
+    /// \param eventType A pointer to an interned event type string.
+    /// \param timestampMicros The timestamp of the event in microseconds.
+    /// \param detail Optional event detail.
+    EventArgs(const void* eventSource,
+              const std::string* eventType,
+              uint64_t timestampMicros,
+              uint64_t detail);
+
+    /// \brief Get a stable pointer to an interned copy of the given string.
+    ///
+    /// Interned strings are never released, so the returned pointer can be
+    /// copied freely between events without touching the string itself.
+    ///
+    /// \param value The string to intern.
+    /// \returns a pointer to the interned string.
+    static const std::string* _intern(const std::string& value);
+
+    /// \brief Replace the values of this EventArgs in place.
+    /// \param eventSource The source of the event.
+    /// \param eventType A pointer to an interned event type string.
+    /// \param timestampMicros The timestamp of the event in microseconds.
+    /// \param detail Optional event detail.
+    void _set(const void* eventSource,
+              const std::string* eventType,
+              uint64_t timestampMicros,
+              uint64_t detail);
+
 private:
     /// \brief A pointer to the event source.
     const void* _eventSource = nullptr;
 
-    /// \brief The name of this event type.
+    /// \brief A pointer to the interned name of this event type.
     /// \sa https://dom.spec.whatwg.org/#dom-event-type
-    std::string _eventType;
+    const std::string* _eventType = &EVENT_TYPE_UNKNOWN;
 
     /// \brief The timestamp of this event in microseconds.
     uint64_t _timestampMicros = 0;
@@ -183,6 +343,95 @@ public:
     /// \returns the axis-aligned width of the shape.
     float axisAlignedHeight() const;
 
+    /// \brief Calculate the axis-aligned size of a shape.
+    ///
+    /// This is the calculation used by axisAlignedWidth() and
+    /// axisAlignedHeight().
+    ///
+    /// \param shapeType The type of the shape.
+    /// \param width The width of the shape.
+    /// \param height The height of the shape.
+    /// \param angleDeg The shape angle in degrees.
+    /// \param axisAlignedWidth The calculated axis-aligned width.
+    /// \param axisAlignedHeight The calculated axis-aligned height.
+    static void toAxisAlignedSize(ShapeType shapeType,
+                                  float width,
+                                  float height,
+                                  float angleDeg,
+                                  float& axisAlignedWidth,
+                                  float& axisAlignedHeight);
+
+    /// \brief Calculate the axis-aligned sizes for arrays of shapes.
+    ///
+    /// This uses SSE2 or NEON when available and otherwise falls back to the
+    /// scalar calculation. No per-shape cache is involved.
+    ///
+    /// \param shapeType The type of all shapes.
+    /// \param widths The widths of the shapes.
+    /// \param heights The heights of the shapes.
+    /// \param anglesDeg The shape angles in degrees.
+    /// \param axisAlignedWidths The calculated axis-aligned widths.
+    /// \param axisAlignedHeights The calculated axis-aligned heights.
+    /// \param size The number of shapes.
+    static void toAxisAlignedSize(ShapeType shapeType,
+                                  const float* widths,
+                                  const float* heights,
+                                  const float* anglesDeg,
+                                  float* axisAlignedWidths,
+                                  float* axisAlignedHeights,
+                                  std::size_t size);
+
+    /// \brief Test if the shape intersects a rectangle.
+    ///
+    /// The rectangle may be rotated about its center. The axis-aligned
+    /// bounds of both are compared first, so the exact test only runs for
+    /// nearby rectangles.
+    ///
+    /// \param position The center of the shape.
+    /// \param rectangle The unrotated rectangle.
+    /// \param rectangleAngleDeg The rectangle angle in degrees.
+    /// \returns true if the shape and the rectangle intersect.
+    bool intersectsRectangle(const glm::vec2& position,
+                             const ofRectangle& rectangle,
+                             float rectangleAngleDeg = 0) const;
+
+    /// \brief Test if the shape intersects a circle.
+    /// \param position The center of the shape.
+    /// \param center The center of the circle.
+    /// \param radius The radius of the circle.
+    /// \returns true if the shape and the circle intersect.
+    bool intersectsCircle(const glm::vec2& position,
+                          const glm::vec2& center,
+                          float radius) const;
+
+    /// \brief Test the shape against many rectangles.
+    ///
+    /// The shape's axis-aligned size is computed once for all rectangles.
+    ///
+    /// \param position The center of the shape.
+    /// \param rectangles The unrotated rectangles.
+    /// \param anglesDeg The rectangle angles in degrees, or nullptr if none
+    ///        of the rectangles are rotated.
+    /// \param size The number of rectangles.
+    /// \param results Set to true for each rectangle that intersects.
+    void intersectsRectangles(const glm::vec2& position,
+                              const ofRectangle* rectangles,
+                              const float* anglesDeg,
+                              std::size_t size,
+                              bool* results) const;
+
+    /// \brief Test the shape against many circles.
+    /// \param position The center of the shape.
+    /// \param centers The centers of the circles.
+    /// \param radii The radii of the circles.
+    /// \param size The number of circles.
+    /// \param results Set to true for each circle that intersects.
+    void intersectsCircles(const glm::vec2& position,
+                           const glm::vec2* centers,
+                           const float* radii,
+                           std::size_t size,
+                           bool* results) const;
+
 protected:
     /// \brief Shape type for the pointer.
     ShapeType _shapeType = ShapeType::ELLIPSE;
@@ -342,10 +591,10 @@ public:
     virtual ~Point();
 
     /// \returns the position in screen coordinates.
-    glm::vec2 position() const;
+    const glm::vec2& position() const;
 
     /// \returns the precise position in screen coordinates.
-    glm::vec2 precisePosition() const;
+    const glm::vec2& precisePosition() const;
 
     /// \brief Get the normalized point pressure.
     ///
@@ -463,6 +712,49 @@ public:
     /// \returns The PointShape.
     const PointShape& shape() const;
 
+    /// \brief Calculate the axis-aligned bounds of the shapes of many points.
+    ///
+    /// Each bounds is centered on the point's position. Shapes of either
+    /// ShapeType may be mixed.
+    ///
+    /// \param points The points.
+    /// \param bounds The calculated bounds. Must hold points.size() elements.
+    static void toAxisAlignedBounds(ConstSpan<Point> points, ofRectangle* bounds);
+
+    /// \param points The points.
+    /// \returns the union of the axis-aligned bounds of the points' shapes.
+    static ofRectangle axisAlignedBounds(ConstSpan<Point> points);
+
+    /// \brief Calculate the azimuth and altitude for the given tilt angles.
+    ///
+    /// This is the calculation used by azimuthDeg() and altitudeDeg().
+    ///
+    /// \param tiltXDeg The tilt X angle in degrees.
+    /// \param tiltYDeg The tilt Y angle in degrees.
+    /// \param azimuthDeg The calculated azimuth in degrees.
+    /// \param altitudeDeg The calculated altitude in degrees.
+    static void toAzimuthAltitudeDeg(float tiltXDeg,
+                                     float tiltYDeg,
+                                     float& azimuthDeg,
+                                     float& altitudeDeg);
+
+    /// \brief Calculate the azimuth and altitude for arrays of tilt angles.
+    ///
+    /// This uses SSE2 or NEON when available and otherwise falls back to the
+    /// scalar calculation. The edge cases match the scalar calculation and
+    /// results agree with it to within single precision.
+    ///
+    /// \param tiltXDeg The tilt X angles in degrees.
+    /// \param tiltYDeg The tilt Y angles in degrees.
+    /// \param azimuthDeg The calculated azimuths in degrees.
+    /// \param altitudeDeg The calculated altitudes in degrees.
+    /// \param size The number of angles.
+    static void toAzimuthAltitudeDeg(const float* tiltXDeg,
+                                     const float* tiltYDeg,
+                                     float* azimuthDeg,
+                                     float* altitudeDeg,
+                                     std::size_t size);
+
     /// \brief A debug utility for viewing the contents of Point.
     /// \returns A string representation of the Point.
     std::string toString() const
@@ -583,6 +875,26 @@ inline void from_json(const nlohmann::json& j, Point& v)
 }
 
 
+/// \brief A snapshot of keyboard modifier and mouse button state.
+///
+/// PointerEvents keeps a PointerInputState up to date from the key and mouse
+/// events it receives, so converting an event does not need to query the
+/// global openFrameworks state.
+struct PointerInputState
+{
+    /// \brief The pressed modifiers, e.g. OF_KEY_CONTROL | OF_KEY_SHIFT.
+    uint16_t modifiers = 0;
+
+    /// \brief The pressed mouse buttons, e.g. 1 << OF_MOUSE_BUTTON_1.
+    uint16_t buttons = 0;
+
+    /// \brief Query the current state from openFrameworks.
+    /// \returns the current state.
+    static PointerInputState fromGlobalState();
+
+};
+
+
 /// \brief A class representing all of the arguments in a pointer event.
 ///
 /// PointerEventArgs are usually passed as arguments in the openFrameworks event
@@ -595,6 +907,56 @@ inline void from_json(const nlohmann::json& j, Point& v)
 class PointerEventArgs: public EventArgs
 {
 public:
+    /// \brief The kind of pointer event.
+    ///
+    /// Each kind corresponds to one of the event type strings below. Custom
+    /// event type strings are represented as CUSTOM.
+    enum class EventKind: uint8_t
+    {
+        UNKNOWN, /// \brief Corresponds to EVENT_TYPE_UNKNOWN.
+        POINTER_OVER, /// \brief Corresponds to POINTER_OVER.
+        POINTER_ENTER, /// \brief Corresponds to POINTER_ENTER.
+        POINTER_DOWN, /// \brief Corresponds to POINTER_DOWN.
+        POINTER_MOVE, /// \brief Corresponds to POINTER_MOVE.
+        POINTER_UP, /// \brief Corresponds to POINTER_UP.
+        POINTER_CANCEL, /// \brief Corresponds to POINTER_CANCEL.
+        POINTER_UPDATE, /// \brief Corresponds to POINTER_UPDATE.
+        POINTER_OUT, /// \brief Corresponds to POINTER_OUT.
+        POINTER_LEAVE, /// \brief Corresponds to POINTER_LEAVE.
+        POINTER_SCROLL, /// \brief Corresponds to POINTER_SCROLL.
+        GOT_POINTER_CAPTURE, /// \brief Corresponds to GOT_POINTER_CAPTURE.
+        LOST_POINTER_CAPTURE, /// \brief Corresponds to LOST_POINTER_CAPTURE.
+        CUSTOM /// \brief A custom event type string.
+    };
+
+    /// \brief The kind of device that generated a pointer event.
+    ///
+    /// Each kind corresponds to one of the device type strings below. Custom
+    /// device type strings are represented as CUSTOM.
+    enum class DeviceKind: uint8_t
+    {
+        UNKNOWN, /// \brief Corresponds to TYPE_UNKNOWN.
+        MOUSE, /// \brief Corresponds to TYPE_MOUSE.
+        PEN, /// \brief Corresponds to TYPE_PEN.
+        TOUCH, /// \brief Corresponds to TYPE_TOUCH.
+        CUSTOM /// \brief A custom device type string.
+    };
+
+    /// \brief Bit flags identifying the properties of a Point.
+    ///
+    /// Used to describe estimated properties and estimated properties that
+    /// are expecting updates. The unused bits are reserved for future
+    /// properties (e.g. azimuth).
+    enum PropertyFlag: uint16_t
+    {
+        PROPERTY_FLAG_NONE = 0, /// \brief No properties.
+        PROPERTY_FLAG_POSITION = 1 << 0, /// \brief Corresponds to PROPERTY_POSITION.
+        PROPERTY_FLAG_PRESSURE = 1 << 1, /// \brief Corresponds to PROPERTY_PRESSURE.
+        PROPERTY_FLAG_TILT_X = 1 << 2, /// \brief Corresponds to PROPERTY_TILT_X.
+        PROPERTY_FLAG_TILT_Y = 1 << 3, /// \brief Corresponds to PROPERTY_TILT_Y.
+        PROPERTY_FLAG_TWIST = 1 << 4 /// \brief Corresponds to PROPERTY_TWIST.
+    };
+
     /// \brief Create a default PointerEventArgs.
     PointerEventArgs();
 
@@ -604,6 +966,12 @@ public:
     PointerEventArgs(const std::string& eventType,
                      const PointerEventArgs& event);
 
+    /// \brief Create a copy of the event with a new event kind.
+    /// \param eventKind The new event kind.
+    /// \param event the event to copy.
+    PointerEventArgs(EventKind eventKind,
+                     const PointerEventArgs& event);
+
     /// \brief Create a PointerEventArgs with parameters.
     /// \param eventSource The event source if available.
     /// \param eventType The pointer event type.
@@ -648,21 +1016,71 @@ public:
                      const std::set<std::string>& estimatedProperties,
                      const std::set<std::string>& estimatedPropertiesExpectingUpdates);
 
+    /// \brief Create a PointerEventArgs with parameters.
+    ///
+    /// This is equivalent to the string-based constructor, but does not need
+    /// to look up or copy any event or device type strings.
+    ///
+    /// \param eventSource The event source if available.
+    /// \param eventKind The pointer event kind.
+    /// \param timestampMicros The timestamp of this event in microseconds
+    /// \param detail The optional event details.
+    /// \param point The point.
+    /// \param pointerId The unique pointer id.
+    /// \param deviceId The unique input device id.
+    /// \param pointerIndex The unique pointer index for the given device id.
+    /// \param sequenceIndex The sequence index for this event or zero if not supported..
+    /// \param deviceKind The device kind.
+    /// \param isCoalesced Is this event delivered as coalesced.
+    /// \param isPredicted Is this event predicted rather than measured.
+    /// \param isPrimary True if this pointer is the primary pointer.
+    /// \param button The button id for this event.
+    /// \param buttons All pressed buttons for this pointer.
+    /// \param modifiers All modifiers for this pointer.
+    /// \param coalescedPointerEvents Pointer events not delivered since the last frame, including a copy of the current event.
+    /// \param predictedPointerEvents Predicted pointer events that will arrive between now and the next frame.
+    /// \param estimatedPropertyFlags The PropertyFlag bits of the estimated properties.
+    /// \param estimatedPropertyFlagsExpectingUpdates The PropertyFlag bits of the estimated properties that are expecting updates.
+    PointerEventArgs(const void* eventSource,
+                     EventKind eventKind,
+                     uint64_t timestampMicros,
+                     uint64_t detail,
+                     const Point& point,
+                     std::size_t pointerId,
+                     int64_t deviceId,
+                     int64_t pointerIndex,
+                     uint64_t sequenceIndex,
+                     DeviceKind deviceKind,
+                     bool isCoalesced,
+                     bool isPredicted,
+                     bool isPrimary,
+                     int16_t button,
+                     uint16_t buttons,
+                     uint16_t modifiers,
+                     ConstSpan<PointerEventArgs> coalescedPointerEvents,
+                     ConstSpan<PointerEventArgs> predictedPointerEvents,
+                     uint16_t estimatedPropertyFlags,
+                     uint16_t estimatedPropertyFlagsExpectingUpdates);
 
     /// \brief Destroy the pointer event args.
     virtual ~PointerEventArgs();
 
     /// \returns the Point data associated with this event.
-    Point point() const;
+    const Point& point() const;
 
     /// \brief Get the position of the event in screen coordinates.
     ///
     /// A convenience method equivalent to point().position();
     ///
     /// \returns the position in screen coordinates.
-    glm::vec2 position() const;
+    const glm::vec2& position() const;
 
     /// \brief Get a single unique id for a device id and Pointer index.
+    ///
+    /// Events dispatched by PointerEvents carry the small, reusable id of
+    /// their active pointer instead.
+    ///
+    /// \sa PointerEvents::ActivePointer
     /// \sa https://w3c.github.io/pointerevents/#dom-pointerevent-pointerid
     /// \returns a single unique id for a device id and Pointer index.
     std::size_t pointerId() const;
@@ -695,7 +1113,13 @@ public:
     /// This string may be TYPE_MOUSE, TYPE_TOUCH, TYPE_PEN, or a custom string.
     ///
     /// \returns a device description string.
-    std::string deviceType() const;
+    const std::string& deviceType() const;
+
+    /// \returns the kind of this event.
+    EventKind eventKind() const;
+
+    /// \returns the kind of device that generated this event.
+    DeviceKind deviceKind() const;
 
     /// \returns true if the event was delivered as a coalesced event.
     bool isCoalesced() const;
@@ -726,31 +1150,59 @@ public:
     /// \returns all modifiers for this pointer.
     uint16_t modifiers() const;
 
-    /// \returns pointer events not delivered since the last frame, including a copy of the current event.
-    std::vector<PointerEventArgs> coalescedPointerEvents() const;
+    /// \brief Get the pointer events not delivered since the last frame.
+    ///
+    /// Includes a copy of the current event. Coalesced events do not have
+    /// coalesced or predicted events of their own.
+    ///
+    /// \returns a view of the coalesced events, valid for the lifetime of this event.
+    ConstSpan<PointerEventArgs> coalescedPointerEvents() const;
 
-    /// \returns predicted pointer events that will arrive between now and the next frame.
-    std::vector<PointerEventArgs> predictedPointerEvents() const;
+    /// \brief Get the predicted pointer events.
+    ///
+    /// Predicted events will arrive between now and the next frame. Predicted
+    /// events do not have coalesced or predicted events of their own.
+    ///
+    /// \returns a view of the predicted events, valid for the lifetime of this event.
+    ConstSpan<PointerEventArgs> predictedPointerEvents() const;
 
+    /// \brief Get a set of estimated properties.
+    ///
+    /// The set is created on demand from estimatedPropertyFlags().
+    ///
     /// \returns a set of estimated properties.
     std::set<std::string> estimatedProperties() const;
 
+    /// \brief Get a set of estimated properties that are expecting updates.
+    ///
+    /// The set is created on demand from
+    /// estimatedPropertyFlagsExpectingUpdates().
+    ///
     /// \returns a set of estimated properties that are expecting updates.
     std::set<std::string> estimatedPropertiesExpectingUpdates() const;
 
+    /// \returns the PropertyFlag bits of the estimated properties.
+    uint16_t estimatedPropertyFlags() const;
+
+    /// \returns the PropertyFlag bits of the estimated properties that are expecting updates.
+    uint16_t estimatedPropertyFlagsExpectingUpdates() const;
+
     /// \brief Attempt to update properties with the given event.
     ///
     /// A property will be updated if:
     ///
     ///     - The sequence() of both events is the same.
-    ///     - The updated property name is in the estimatedProperties() set.
-    ///     - The updated property name is in the estimatedPropertiesExpectingUpdates() set.
+    ///     - The updated property is in estimatedPropertyFlagsExpectingUpdates().
+    ///     - The updated property is not in e.estimatedPropertyFlags().
     ///
     /// \returns true if this event was successfully updated.
     bool updateEstimatedPropertiesWithEvent(const PointerEventArgs& e);
 
     /// \brief Utility to convert ofTouchEventArgs events to PointerEventArgs.
-    /// \todo Does not set "isPrimary" correctly since it has no context.
+    /// \note isPrimary is guessed without context. PointerEvents assigns it
+    /// from its active pointer table when the event is dispatched.
+    /// \note This allocates a new event. Use the in-place overloads to reuse
+    /// an existing event without allocating.
     /// \param source The event source.
     /// \param e The touch event to convert.
     /// \returns a PointerEventArgs.
@@ -758,13 +1210,132 @@ public:
                                                const ofTouchEventArgs& e);
 
     /// \brief Utility to convert ofTouchEventArgs events to PointerEventArgs.
-    /// \todo Does not set "isPrimary" correctly since it has no context.
-    /// \param e The touch event to convert.
+    /// \note isPrimary is guessed without context. PointerEvents assigns it
+    /// from its active pointer table when the event is dispatched.
+    /// \note This allocates a new event. Use the in-place overloads to reuse
+    /// an existing event without allocating.
     /// \param source The event source.
+    /// \param e The mouse event to convert.
     /// \returns a PointerEventArgs.
     static PointerEventArgs toPointerEventArgs(const void* source,
                                                const ofMouseEventArgs& e);
 
+    /// \brief Convert ofTouchEventArgs to PointerEventArgs in place.
+    ///
+    /// All values of the given event are replaced. Its sample storage is
+    /// reused, so converting into the same event repeatedly does not
+    /// allocate after the first conversion. Listeners of
+    /// pointerPropertyUpdate are not modified.
+    ///
+    /// \note isPrimary is guessed without context. PointerEvents assigns it
+    /// from its active pointer table when the event is dispatched.
+    /// \param source The event source.
+    /// \param e The touch event to convert.
+    /// \param event The event to fill.
+    static void toPointerEventArgs(const void* source,
+                                   const ofTouchEventArgs& e,
+                                   PointerEventArgs& event);
+
+    /// \brief Convert ofTouchEventArgs to PointerEventArgs in place.
+    ///
+    /// Like toPointerEventArgs(source, e, event), but modifiers are read from
+    /// the given input state rather than queried from openFrameworks.
+    ///
+    /// \note isPrimary is guessed without context. PointerEvents assigns it
+    /// from its active pointer table when the event is dispatched.
+    /// \param source The event source.
+    /// \param e The touch event to convert.
+    /// \param inputState The current input state.
+    /// \param event The event to fill.
+    static void toPointerEventArgs(const void* source,
+                                   const ofTouchEventArgs& e,
+                                   const PointerInputState& inputState,
+                                   PointerEventArgs& event);
+
+    /// \brief Convert ofMouseEventArgs to PointerEventArgs in place.
+    ///
+    /// All values of the given event are replaced. Its sample storage is
+    /// reused, so converting into the same event repeatedly does not
+    /// allocate after the first conversion. Listeners of
+    /// pointerPropertyUpdate are not modified.
+    ///
+    /// \param source The event source.
+    /// \param e The mouse event to convert.
+    /// \param event The event to fill.
+    static void toPointerEventArgs(const void* source,
+                                   const ofMouseEventArgs& e,
+                                   PointerEventArgs& event);
+
+    /// \brief Convert ofMouseEventArgs to PointerEventArgs in place.
+    ///
+    /// Like toPointerEventArgs(source, e, event), but modifiers and buttons
+    /// are read from the given input state rather than queried from
+    /// openFrameworks.
+    ///
+    /// \param source The event source.
+    /// \param e The mouse event to convert.
+    /// \param inputState The current input state.
+    /// \param event The event to fill.
+    static void toPointerEventArgs(const void* source,
+                                   const ofMouseEventArgs& e,
+                                   const PointerInputState& inputState,
+                                   PointerEventArgs& event);
+
+    /// \brief Utility to convert a PointerSample to PointerEventArgs.
+    ///
+    /// Properties not carried by the PointerSample are set to their defaults.
+    /// In particular the PointShape is a zero-size point, so hit testing
+    /// treats the event as a point, and the device id, pointer index, button,
+    /// modifiers and tangential pressure are 0 or -1. The event is its own
+    /// coalesced sample.
+    ///
+    /// \param source The event source.
+    /// \param sample The sample to convert.
+    /// \returns a PointerEventArgs.
+    static PointerEventArgs toPointerEventArgs(const void* source,
+                                               const PointerSample& sample);
+
+    /// \returns a compact PointerSample of this event.
+    PointerSample toPointerSample() const;
+
+    /// \brief Combine a device kind, device id and pointer index into a
+    /// source pointer id.
+    ///
+    /// The id is made by packing the values into bits, without hashing. The
+    /// top bit is always set, so source ids never collide with the small ids
+    /// issued by PointerEvents.
+    ///
+    /// \param deviceKind The kind of device.
+    /// \param deviceId The device id.
+    /// \param pointerIndex The pointer index on the device.
+    /// \returns the source pointer id.
+    static std::size_t toSourcePointerId(DeviceKind deviceKind,
+                                         int64_t deviceId,
+                                         int64_t pointerIndex);
+
+    /// \brief Convert an event type string to an EventKind.
+    /// \param eventType The event type string.
+    /// \returns the matching EventKind or EventKind::CUSTOM if none matches.
+    static EventKind toEventKind(const std::string& eventType);
+
+    /// \brief Convert a device type string to a DeviceKind.
+    /// \param deviceType The device type string.
+    /// \returns the matching DeviceKind or DeviceKind::CUSTOM if none matches.
+    static DeviceKind toDeviceKind(const std::string& deviceType);
+
+    /// \brief Convert a set of property keys to PropertyFlag bits.
+    ///
+    /// Unknown property keys are ignored with a warning.
+    ///
+    /// \param properties The set of property keys.
+    /// \returns the PropertyFlag bits.
+    static uint16_t toPropertyFlags(const std::set<std::string>& properties);
+
+    /// \brief Convert PropertyFlag bits to a set of property keys.
+    /// \param propertyFlags The PropertyFlag bits.
+    /// \returns the set of property keys.
+    static std::set<std::string> toPropertySet(uint16_t propertyFlags);
+
     /// \brief A debug utility for viewing the contents of PointerEventArgs.
     /// \returns A string representation of the PointerEventArgs.
     std::string toString() const
@@ -854,6 +1425,9 @@ public:
     /// \brief Property key for tilt y.
     static const std::string PROPERTY_TILT_Y;
 
+    /// \brief Property key for twist.
+    static const std::string PROPERTY_TWIST;
+
     friend std::ostream& operator << (std::ostream& os, const PointerEventArgs& e);
 
 private:
@@ -875,8 +1449,14 @@ private:
     /// \brief The monotonically increasing sequence index for this event.
     uint64_t _sequenceIndex = 0;
 
-    /// \brief The type of device that generated this Point.
-    std::string _deviceType = TYPE_UNKNOWN;
+    /// \brief The kind of this event.
+    EventKind _eventKind = EventKind::UNKNOWN;
+
+    /// \brief The kind of device that generated this Point.
+    DeviceKind _deviceKind = DeviceKind::UNKNOWN;
+
+    /// \brief A pointer to the interned type of device that generated this Point.
+    const std::string* _deviceType = &TYPE_UNKNOWN;
 
     /// \brief Indicates if the event was delivered as a coalesced event.
     bool _isCoalesced = false;
@@ -904,23 +1484,132 @@ private:
     /// \brief The current modifiers being pressed.
     uint16_t _modifiers = 0;
 
-    /// \brief Pointer events not delivered since the last frame, including a copy of the current event.
-    std::vector<PointerEventArgs> _coalescedPointerEvents;
+    /// \brief Coalesced pointer events followed by predicted pointer events.
+    ///
+    /// All samples are stored in a single flat buffer and the samples never
+    /// have samples of their own. Each sample is still a PointerEventArgs,
+    /// whose pointerPropertyUpdate event allocates its shared data when it is
+    /// constructed. Building N new samples therefore costs N allocations plus
+    /// one for the buffer. The in-place conversions reuse existing samples
+    /// and don't allocate once the buffer has grown.
+    std::vector<PointerEventArgs> _samples;
+
+    /// \brief The number of coalesced pointer events at the front of _samples.
+    std::size_t _numCoalescedSamples = 0;
+
+    /// \brief Create a copy of the event without samples and with a new event type.
+    /// \param eventType A pointer to the interned event type.
+    /// \param eventKind The new event kind.
+    /// \param event the event to copy.
+    PointerEventArgs(const std::string* eventType,
+                     EventKind eventKind,
+                     const PointerEventArgs& event);
+
+    /// \brief Replace the coalesced and predicted events.
+    ///
+    /// The given events are copied into a single flat allocation without
+    /// their own coalesced or predicted events.
+    ///
+    /// \param coalescedPointerEvents The coalesced events.
+    /// \param predictedPointerEvents The predicted events.
+    void _setSamples(ConstSpan<PointerEventArgs> coalescedPointerEvents,
+                     ConstSpan<PointerEventArgs> predictedPointerEvents);
+
+    /// \brief Make a copy of this event its only coalesced event.
+    ///
+    /// Existing sample storage is reused.
+    void _setSamplesToSelf();
+
+    /// \brief Merge a later event of the same pointer into this event.
+    ///
+    /// The samples of this event and the coalesced events of the given event
+    /// become the coalesced events. The predicted events and all other values
+    /// are taken from the given event.
+    ///
+    /// \param event The later event.
+    void _coalesce(const PointerEventArgs& event);
 
-    /// \brief Predicted pointer events that will arrive between now and the next frame.
-    std::vector<PointerEventArgs> _predictedPointerEvents;
+    /// \brief Replace all values except samples with those of another event.
+    /// \param event The event to copy.
+    void _assignWithoutSamples(const PointerEventArgs& event);
 
-    /// \brief A set of estimated properties.
-    std::set<std::string> _estimatedProperties;
+    /// \brief Replace all values except samples with those of another event
+    /// and change the event kind.
+    ///
+    /// Any existing samples are cleared, keeping their storage.
+    ///
+    /// \param eventKind The new event kind.
+    /// \param event The event to copy.
+    void _assignWithoutSamples(EventKind eventKind, const PointerEventArgs& event);
 
-    /// \param A set of estimated properties that are expecting updates.
-    std::set<std::string> _estimatedPropertiesExpectingUpdates;
+    /// \brief Replace all values except samples in place.
+    /// \param eventSource The source of the event.
+    /// \param eventKind The kind of the event.
+    /// \param timestampMicros The timestamp of the event in microseconds.
+    /// \param detail Optional event detail.
+    /// \param point The point.
+    /// \param pointerId The unique pointer id.
+    /// \param deviceId The unique input device id.
+    /// \param pointerIndex The unique pointer index for the given device id.
+    /// \param sequenceIndex The sequence index of this event.
+    /// \param deviceKind The kind of device that created this pointer event.
+    /// \param isCoalesced True if the event is a coalesced event.
+    /// \param isPredicted True if the event is a predicted event.
+    /// \param isPrimary True if this pointer is the primary pointer.
+    /// \param button The button id for this event.
+    /// \param buttons All pressed button ids for this pointer.
+    /// \param modifiers All modifiers for this pointer.
+    /// \param estimatedPropertyFlags The PropertyFlag bits of the estimated properties.
+    /// \param estimatedPropertyFlagsExpectingUpdates The PropertyFlag bits of the estimated properties expecting updates.
+    void _assign(const void* eventSource,
+                 EventKind eventKind,
+                 uint64_t timestampMicros,
+                 uint64_t detail,
+                 const Point& point,
+                 std::size_t pointerId,
+                 int64_t deviceId,
+                 int64_t pointerIndex,
+                 uint64_t sequenceIndex,
+                 DeviceKind deviceKind,
+                 bool isCoalesced,
+                 bool isPredicted,
+                 bool isPrimary,
+                 int16_t button,
+                 uint16_t buttons,
+                 uint16_t modifiers,
+                 uint16_t estimatedPropertyFlags,
+                 uint16_t estimatedPropertyFlagsExpectingUpdates);
+
+    /// \brief The PropertyFlag bits of the estimated properties.
+    uint16_t _estimatedPropertyFlags = PROPERTY_FLAG_NONE;
+
+    /// \brief The PropertyFlag bits of the estimated properties that are expecting updates.
+    uint16_t _estimatedPropertyFlagsExpectingUpdates = PROPERTY_FLAG_NONE;
 
     friend class PointerEvents;
+    friend class PointerTargets;
 
 };
 
 
+/// \brief Get the event type string for an EventKind.
+///
+/// EventKind::CUSTOM has no single string and returns EVENT_TYPE_UNKNOWN.
+///
+/// \param v The EventKind to convert.
+/// \returns the matching event type string.
+const std::string& to_string(PointerEventArgs::EventKind v);
+
+
+/// \brief Get the device type string for a DeviceKind.
+///
+/// DeviceKind::CUSTOM has no single string and returns TYPE_UNKNOWN.
+///
+/// \param v The DeviceKind to convert.
+/// \returns the matching device type string.
+const std::string& to_string(PointerEventArgs::DeviceKind v);
+
+
 /// \brief Write a PointerEventArgs to a std::ostream.
 /// \param os The std::ostream to write to.
 /// \param e The event to write.
@@ -985,47 +1674,437 @@ inline void from_json(const nlohmann::json& j, PointerEventArgs& v)
 }
 
 
-/// \brief A class for converting touch and mouse events into pointer events.
+/// \brief A compact, trivially copyable sample of a single pointer event.
 ///
-/// This class is a source of pointer events.  It captures mouse and touch
-/// events from openFrameworks or an external source and repackages and
-/// distributes them as pointer events.
+/// A PointerSample occupies a single 64 byte cache line and is intended for
+/// storing large numbers of pointer events, e.g. in a PointerStroke.
 ///
-/// This should not be accessed directly.
-class PointerEvents
+/// It carries the position, pressure, tilt, twist, timing, identity, buttons
+/// and flags of an event. It does not carry the event source, PointShape,
+/// device id, pointer index, button, modifiers, tangential pressure or the
+/// coalesced and predicted events. There is no room for them in the cache
+/// line, so converting an event to a sample and back is lossy: the event
+/// returned by PointerEventArgs::toPointerEventArgs() is a zero-size contact
+/// with these properties at their defaults.
+struct PointerSample
 {
-public:
-//    enum EventSource
-//    {
-//        LEGACY_EVENTS,
-//        EXTERNAL_EVENTS
-//    };
+    /// \brief Bit flags describing the sample.
+    enum Flag: uint8_t
+    {
+        FLAG_NONE = 0, /// \brief No flags.
+        FLAG_COALESCED = 1 << 0, /// \brief Corresponds to PointerEventArgs::isCoalesced().
+        FLAG_PREDICTED = 1 << 1, /// \brief Corresponds to PointerEventArgs::isPredicted().
+        FLAG_PRIMARY = 1 << 2 /// \brief Corresponds to PointerEventArgs::isPrimary().
+    };
 
-    /// \brief Create a PointerEvents object with the given source.
-    /// \param source The window that will provide the events.
-    PointerEvents(ofAppBaseWindow* window);
+    /// \brief The timestamp of the event in microseconds.
+    uint64_t timestampMicros = 0;
 
-    /// \brief Destroy the PointerEvents.
-    ~PointerEvents();
+    /// \brief The unique pointer id.
+    uint64_t pointerId = 0;
 
-    /// \brief Pointer event callback.
-    /// \param source The event source.
-    /// \param e the event arguments.
-    /// \returns true of the event was consumed.
-    bool onPointerEvent(const void* source, PointerEventArgs& e);
+    /// \brief The sequence index of the event or zero if not supported.
+    uint64_t sequenceIndex = 0;
+
+    /// \brief The position in screen coordinates.
+    glm::vec2 position = { 0, 0 };
+
+    /// \brief The precise position in screen coordinates.
+    glm::vec2 precisePosition = { 0, 0 };
+
+    /// \brief The normalized pressure.
+    float pressure = 0;
+
+    /// \brief The twist angle in degrees.
+    float twistDeg = 0;
+
+    /// \brief The tilt X angle in degrees.
+    float tiltXDeg = 0;
+
+    /// \brief The tilt Y angle in degrees.
+    float tiltYDeg = 0;
+
+    /// \brief All pressed buttons for the pointer.
+    uint16_t buttons = 0;
+
+    /// \brief The kind of the event.
+    PointerEventArgs::EventKind eventKind = PointerEventArgs::EventKind::UNKNOWN;
+
+    /// \brief The kind of device that generated the event.
+    PointerEventArgs::DeviceKind deviceKind = PointerEventArgs::DeviceKind::UNKNOWN;
+
+    /// \brief The Flag bits of the sample.
+    uint8_t flags = FLAG_NONE;
+
+    /// \brief The PointerEventArgs::PropertyFlag bits of the estimated properties.
+    uint8_t estimatedPropertyFlags = PointerEventArgs::PROPERTY_FLAG_NONE;
+
+    /// \brief The PointerEventArgs::PropertyFlag bits of the estimated properties expecting updates.
+    uint8_t estimatedPropertyFlagsExpectingUpdates = PointerEventArgs::PROPERTY_FLAG_NONE;
+
+    /// \returns true if the sample was delivered as a coalesced event.
+    bool isCoalesced() const
+    {
+        return flags & FLAG_COALESCED;
+    }
+
+    /// \returns true if the sample was predicted rather than measured.
+    bool isPredicted() const
+    {
+        return flags & FLAG_PREDICTED;
+    }
+
+    /// \returns true if the sample belongs to the primary pointer.
+    bool isPrimary() const
+    {
+        return flags & FLAG_PRIMARY;
+    }
+
+    /// \returns true if any properties are estimated.
+    bool isEstimated() const
+    {
+        return estimatedPropertyFlags != PointerEventArgs::PROPERTY_FLAG_NONE;
+    }
+
+    /// \brief Attempt to update properties with the given event.
+    ///
+    /// This follows the same rules as
+    /// PointerEventArgs::updateEstimatedPropertiesWithEvent(), but does not
+    /// notify any listeners.
+    ///
+    /// \returns true if this sample was successfully updated.
+    bool updateEstimatedPropertiesWithEvent(const PointerEventArgs& e);
+
+};
+
+
+static_assert(sizeof(PointerSample) == 64, "PointerSample should fit in a single cache line.");
+static_assert(std::is_trivially_copyable<PointerSample>::value, "PointerSample should be trivially copyable.");
+
+
+/// \brief Criteria that a pointer event must match to be delivered to a
+/// filtered event.
+///
+/// A default PointerEventFilter matches every event. Each criterion narrows
+/// the set of matching events.
+///
+/// \sa PointerEvents::filteredEvent()
+struct PointerEventFilter
+{
+    /// \brief A mask that includes every kind.
+    static const uint32_t ALL_KINDS = 0xFFFFFFFF;
+
+    /// \brief Matching device kinds as a combination of toMask() bits.
+    uint32_t deviceKindMask = ALL_KINDS;
+
+    /// \brief Matching event kinds as a combination of toMask() bits.
+    uint32_t eventKindMask = ALL_KINDS;
+
+    /// \brief True if only primary pointer events match.
+    bool primaryOnly = false;
+
+    /// \brief True if only events of pointerId match.
+    bool hasPointerId = false;
+
+    /// \brief The matching pointer id if hasPointerId is true.
+    std::size_t pointerId = 0;
+
+    /// \param e The event to test.
+    /// \returns true if the event matches all criteria.
+    bool matches(const PointerEventArgs& e) const;
+
+    /// \param eventKind The event kind.
+    /// \returns true if the event kind is included by eventKindMask.
+    bool matchesEventKind(PointerEventArgs::EventKind eventKind) const;
+
+    bool operator == (const PointerEventFilter& other) const;
+
+    /// \param deviceKind The device kind.
+    /// \returns the deviceKindMask bit of the device kind.
+    static uint32_t toMask(PointerEventArgs::DeviceKind deviceKind);
+
+    /// \param eventKind The event kind.
+    /// \returns the eventKindMask bit of the event kind.
+    static uint32_t toMask(PointerEventArgs::EventKind eventKind);
+
+};
+
+
+/// \brief A bounded, lock-free, multiple producer, single consumer queue.
+///
+/// This is based on Dmitry Vyukov's bounded MPMC queue. Each cell carries a
+/// sequence number that tells producers and the consumer whether the cell is
+/// free or filled. Producers claim a cell with a single compare-and-swap and
+/// never wait for each other. Only one thread may consume.
+///
+/// All cells are constructed up front, so values are copy-assigned into
+/// existing storage and a full queue rejects new values instead of growing.
+///
+/// \tparam T The element type. Must be default constructible and copy
+/// assignable.
+template <typename T>
+class BoundedMPSCQueue
+{
+public:
+    /// \brief Create a BoundedMPSCQueue.
+    /// \param capacity The minimum capacity. It is rounded up to a power of
+    /// two of at least 2.
+    explicit BoundedMPSCQueue(std::size_t capacity)
+    {
+        std::size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+
+        _cells.reset(new Cell[size]);
+        _mask = size - 1;
+
+        for (std::size_t i = 0; i < size; ++i)
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    BoundedMPSCQueue(const BoundedMPSCQueue&) = delete;
+    BoundedMPSCQueue& operator = (const BoundedMPSCQueue&) = delete;
+
+    /// \brief Push a value. May be called from any thread.
+    /// \param value The value to copy into the queue.
+    /// \returns false if the queue was full and the value was not pushed.
+    bool push(const T& value)
+    {
+        std::size_t position = _enqueuePosition.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+
+        for (;;)
+        {
+            cell = &_cells[position & _mask];
+            std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+            if (difference == 0)
+            {
+                if (_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = _enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = value;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// \brief Pop the oldest value. Must only be called by the consumer.
+    /// \param value The value to copy the popped value into.
+    /// \returns false if the queue was empty.
+    bool pop(T& value)
+    {
+        Cell* cell = &_cells[_dequeuePosition & _mask];
+        std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+
+        if (sequence != _dequeuePosition + 1)
+            return false;
+
+        value = cell->value;
+        cell->sequence.store(_dequeuePosition + _mask + 1, std::memory_order_release);
+        ++_dequeuePosition;
+        return true;
+    }
+
+    /// \returns the number of values the queue can hold.
+    std::size_t capacity() const
+    {
+        return _mask + 1;
+    }
+
+private:
+    /// \brief A queue cell.
+    struct Cell
+    {
+        /// \brief The cell's sequence number.
+        std::atomic<std::size_t> sequence;
+
+        /// \brief The cell's value.
+        T value;
+    };
+
+    /// \brief The cells.
+    std::unique_ptr<Cell[]> _cells;
+
+    /// \brief The capacity minus one.
+    std::size_t _mask = 0;
+
+    /// \brief The next position to push to, shared by the producers.
+    std::atomic<std::size_t> _enqueuePosition { 0 };
+
+    /// \brief Keeps the positions on separate cache lines without
+    /// over-aligning the queue, so it can be allocated with new in C++14.
+    char _padding[64];
+
+    /// \brief The next position to pop from, owned by the consumer.
+    std::size_t _dequeuePosition = 0;
+
+};
+
+
+/// \brief A class for converting touch and mouse events into pointer events.
+///
+/// This class is a source of pointer events.  It captures mouse and touch
+/// events from openFrameworks or an external source and repackages and
+/// distributes them as pointer events.
+///
+/// This should not be accessed directly.
+class PointerEvents
+{
+public:
+//    enum EventSource
+//    {
+//        LEGACY_EVENTS,
+//        EXTERNAL_EVENTS
+//    };
+
+    /// \brief Create a PointerEvents object with the given source.
+    /// \param source The window that will provide the events.
+    /// \param postedEventCapacity The capacity of each posted event queue.
+    PointerEvents(ofAppBaseWindow* window,
+                  std::size_t postedEventCapacity = DEFAULT_POSTED_EVENT_CAPACITY);
+
+    /// \brief Destroy the PointerEvents.
+    ~PointerEvents();
+
+    PointerEvents(const PointerEvents&) = delete;
+    PointerEvents& operator = (const PointerEvents&) = delete;
+
+    /// \brief Pointer event callback.
+    ///
+    /// This must be called on the thread that dispatches events. Other
+    /// threads should use postPointerEvent().
+    ///
+    /// The event is modified in place before it is dispatched: its pointer
+    /// id and the pointer ids of its samples are replaced by the small id of
+    /// its active pointer, and isPrimary is assigned. Callers that need the
+    /// original values should pass a copy.
+    ///
+    /// \sa ActivePointer
+    /// \param source The event source.
+    /// \param e the event arguments.
+    /// \returns true of the event was consumed.
+    bool onPointerEvent(const void* source, PointerEventArgs& e);
 
     /// \brief Mouse event callback.
+    ///
+    /// The event is converted into a reused PointerEventArgs without
+    /// allocating. A nested event raised by a listener during dispatch is
+    /// converted into a temporary PointerEventArgs, which allocates.
+    ///
     /// \param source The event source.
     /// \param e the event arguments.
     /// \returns true of the event was consumed.
     bool onMouseEvent(const void* source, ofMouseEventArgs& e);
 
     /// \brief Touch event callback.
+    ///
+    /// The event is converted into a reused PointerEventArgs without
+    /// allocating. A nested event raised by a listener during dispatch is
+    /// converted into a temporary PointerEventArgs, which allocates.
+    ///
     /// \param source The event source.
     /// \param e the event arguments.
     /// \returns true of the event was handled.
     bool onTouchEvent(const void* source, ofTouchEventArgs& e);
 
+    /// \brief Key event callback.
+    ///
+    /// Key events are used to track modifier keys and are never consumed.
+    ///
+    /// \param source The event source.
+    /// \param e the event arguments.
+    /// \returns false.
+    bool onKeyEvent(const void* source, ofKeyEventArgs& e);
+
+    /// \returns the modifier and mouse button state used for conversion.
+    const PointerInputState& inputState() const;
+
+    /// \brief Update event callback.
+    ///
+    /// Flushes events queued by frame batching.
+    ///
+    /// \param e the event arguments.
+    void onUpdate(ofEventArgs& e);
+
+    /// \brief Enable or disable frame batching.
+    ///
+    /// When frame batching is enabled, pointer events are queued rather than
+    /// dispatched immediately. Consecutive pointermove events of a pointer are
+    /// merged into one event that carries the intermediate samples as
+    /// coalesced events. Queued events are dispatched in order by flush(),
+    /// which is called on the source window's update event.
+    ///
+    /// While batching, mouse and touch callbacks cannot report whether their
+    /// event was consumed. Disabling frame batching flushes queued events. If
+    /// it is disabled by a listener during a flush, the events queued so far
+    /// are dispatched before that flush returns.
+    ///
+    /// \param enabled True if frame batching should be enabled.
+    void setFrameBatchingEnabled(bool enabled);
+
+    /// \returns true if frame batching is enabled.
+    bool isFrameBatchingEnabled() const;
+
+    /// \brief Dispatch all posted events and events queued by frame batching.
+    void flush();
+
+    /// \brief Post a pointer event from any thread.
+    ///
+    /// Posted events are dispatched on the thread that calls flush(), which
+    /// is usually the main thread during the source window's update event.
+    /// Events posted by all threads since the last flush are dispatched in
+    /// timestamp order. If frame batching is enabled, they are batched like
+    /// any other event.
+    ///
+    /// Posting never blocks. If the queue is full, the event is dropped and
+    /// counted by droppedEventCount().
+    ///
+    /// The event queue is allocated by the first call. The event is copied
+    /// into a queue cell, which may allocate if the event has more coalesced
+    /// or predicted samples than the cell held before. Use
+    /// postPointerSample() where allocations must be avoided.
+    ///
+    /// \param e the event arguments.
+    /// \returns true if the event was posted, false if it was dropped.
+    bool postPointerEvent(const PointerEventArgs& e);
+
+    /// \brief Post a compact pointer sample from any thread.
+    ///
+    /// This is cheaper than postPointerEvent() for producers that only
+    /// have the properties carried by a PointerSample. Samples are converted
+    /// with PointerEventArgs::toPointerEventArgs() when they are dispatched
+    /// and are ordered together with posted events.
+    ///
+    /// The dispatched events don't have a contact shape, device id, pointer
+    /// index, button, modifiers or tangential pressure, so touches posted
+    /// this way are hit tested as points. Use postPointerEvent() for
+    /// producers that need these properties.
+    ///
+    /// \param sample The sample to post.
+    /// \returns true if the sample was posted, false if it was dropped.
+    bool postPointerSample(const PointerSample& sample);
+
+    /// \returns the number of events and samples posted successfully.
+    uint64_t postedEventCount() const;
+
+    /// \returns the number of events and samples dropped because a posted
+    /// event queue was full.
+    uint64_t droppedEventCount() const;
+
+    /// \brief The default capacity of each posted event queue.
+    static const std::size_t DEFAULT_POSTED_EVENT_CAPACITY = 1024;
+
 //    /// \brief Disable legacy mouse / touch events.
 //    ///
 //    /// If legacy mouse / touch events are disabled, they will be automatically
@@ -1124,227 +2203,1587 @@ public:
     ///     touches it with a third finger, this event is raised.
     ofEvent<PointerEventArgs> pointerCancel;
 
-    /// \brief Event that is triggered when a point has been updated.
-    ///
-    /// This event can be called in systems that offer updates to estimated
-    /// pointer property data. For instance, iOS offers updates when using the
-    /// iPencil. To update the point, the user can compare the
-    ///
-    ///     PointerEventArgs::estimatedProperties()
-    ///
-    /// Triggered after pointerEvent, if pointerEvent is not consumed.
-    ofEvent<PointerEventArgs> pointerUpdate;
+    /// \brief Event that is triggered when a point has been updated.
+    ///
+    /// This event can be called in systems that offer updates to estimated
+    /// pointer property data. For instance, iOS offers updates when using the
+    /// iPencil. To update the point, the user can compare the
+    ///
+    ///     PointerEventArgs::estimatedProperties()
+    ///
+    /// Triggered after pointerEvent, if pointerEvent is not consumed.
+    ofEvent<PointerEventArgs> pointerUpdate;
+
+    /// \brief Event that is triggered when a pointer moves into a hit target.
+    ///
+    /// Triggered after pointerEvent, if pointerEvent is not consumed.
+    ofEvent<PointerEventArgs> pointerOver;
+
+    /// \brief Event that is triggered when a pointer enters a hit target or
+    /// the source window.
+    ///
+    /// Triggered after pointerEvent, if pointerEvent is not consumed.
+    ofEvent<PointerEventArgs> pointerEnter;
+
+    /// \brief Event that is triggered when a pointer moves out of a hit target.
+    ///
+    /// Triggered after pointerEvent, if pointerEvent is not consumed.
+    ofEvent<PointerEventArgs> pointerOut;
+
+    /// \brief Event that is triggered when a pointer leaves a hit target or
+    /// the source window.
+    ///
+    /// Triggered after pointerEvent, if pointerEvent is not consumed.
+    ofEvent<PointerEventArgs> pointerLeave;
+
+    /// \brief Event that is triggered when a pointer scrolls.
+    ///
+    /// Triggered after pointerEvent, if pointerEvent is not consumed.
+    ofEvent<PointerEventArgs> pointerScroll;
+
+    /// \brief Event that is triggered when a pointer is captured.
+    ///
+    /// Triggered after pointerEvent, if pointerEvent is not consumed.
+    ofEvent<PointerEventArgs> gotPointerCapture;
+
+    /// \brief Event that is triggered when a pointer capture is released.
+    ///
+    /// Triggered after pointerEvent, if pointerEvent is not consumed.
+    ofEvent<PointerEventArgs> lostPointerCapture;
+
+    /// \brief Event that is triggered for each event of a captured pointer.
+    ///
+    /// Captured events are only delivered to the capture owner and are not
+    /// broadcast. This event is triggered after the owner received one, so
+    /// that observers that keep state per pointer, such as PointerTargets,
+    /// can follow the pointer. Its return value is ignored.
+    ofEvent<PointerEventArgs> capturedPointerEvent;
+
+    /// \brief Get an event that is only notified for matching pointer events.
+    ///
+    /// Filters are evaluated once per event inside PointerEvents, so
+    /// listeners of a filtered event are never called for events they are
+    /// not interested in. Filtered events are notified after pointerEvent
+    /// and before the typed events, in the order they were first requested,
+    /// and only if the event has not been consumed. Requesting an equal
+    /// filter returns the same event. Filtered events live as long as the
+    /// PointerEvents.
+    ///
+    /// \param filter The filter that events must match.
+    /// \returns the filtered event.
+    ofEvent<PointerEventArgs>& filteredEvent(const PointerEventFilter& filter);
+
+    /// \brief A function that receives the events of a captured pointer.
+    /// \param e the event arguments.
+    /// \returns true if the event was consumed.
+    typedef std::function<bool(PointerEventArgs& e)> PointerCaptureCallback;
+
+    /// \brief Capture a pointer.
+    ///
+    /// While a pointer is captured, its events are delivered only to the
+    /// capture callback and are not broadcast to any other listener. As in
+    /// the Pointer Events specification, the capture takes effect before the
+    /// next event of the pointer is dispatched. At that point the owner
+    /// receives a GOT_POINTER_CAPTURE event, and a previous owner receives a
+    /// LOST_POINTER_CAPTURE event. Capture events are also broadcast through
+    /// pointerEvent and the typed capture events if the owner does not
+    /// consume them.
+    ///
+    /// The capture is released automatically after the pointer's next
+    /// POINTER_UP, POINTER_CANCEL or POINTER_LEAVE event. A capture that has
+    /// not taken effect when the pointer is removed from the active pointers
+    /// is dropped. The owner must release the capture before it is destroyed.
+    ///
+    /// Only active pointers can be captured. The request is ignored if the
+    /// pointer is not active.
+    ///
+    /// \param pointerId The id of the pointer to capture.
+    /// \param owner The owner that identifies the capture.
+    /// \param callback The function that receives the pointer's events.
+    void setPointerCapture(std::size_t pointerId,
+                           const void* owner,
+                           PointerCaptureCallback callback);
+
+    /// \brief Capture a pointer to a listener.
+    ///
+    /// The listener's `onPointerEvent(PointerEventArgs& evt)` method receives
+    /// the pointer's events.
+    ///
+    /// \tparam ListenerClass The class of the listener.
+    /// \param pointerId The id of the pointer to capture.
+    /// \param listener A pointer to the listener, which is also the owner.
+    template <class ListenerClass>
+    void setPointerCapture(std::size_t pointerId, ListenerClass* listener);
+
+    /// \brief Release a pointer capture.
+    ///
+    /// Nothing happens if the owner does not have the pointer capture. The
+    /// owner receives a LOST_POINTER_CAPTURE event before the next event of
+    /// the pointer is dispatched.
+    ///
+    /// \param pointerId The id of the captured pointer.
+    /// \param owner The owner of the capture.
+    void releasePointerCapture(std::size_t pointerId, const void* owner);
+
+    /// \param pointerId The id of the pointer.
+    /// \param owner The owner to test.
+    /// \returns true if the owner has or is about to get the pointer capture.
+    bool hasPointerCapture(std::size_t pointerId, const void* owner) const;
+
+    /// \brief A pointer that is currently active.
+    ///
+    /// A pointer is active from its first event until it is removed. Touch
+    /// and pen pointers are removed after POINTER_UP. All pointers are
+    /// removed after POINTER_CANCEL and when they leave the source window.
+    ///
+    /// Each active pointer is given a small pointer id in the range
+    /// [0, MAX_ACTIVE_POINTERS), which replaces the pointer id of its events
+    /// when they are dispatched. Ids are reused after their pointer is
+    /// removed, least recently released first.
+    ///
+    /// If MAX_ACTIVE_POINTERS pointers are already active, the events of
+    /// further pointers are dispatched with their source pointer id instead.
+    /// Source pointer ids can have any value, so dispatched pointer ids at or
+    /// above MAX_ACTIVE_POINTERS can occur. Downstream code can use ids below
+    /// MAX_ACTIVE_POINTERS to index arrays directly, but must check the id
+    /// first and handle larger ids separately, as PointerDebugRenderer does.
+    struct ActivePointer
+    {
+        /// \brief The small pointer id used for dispatched events.
+        std::size_t pointerId = 0;
+
+        /// \brief The pointer id the events arrived with.
+        std::size_t sourcePointerId = 0;
+
+        /// \brief The kind of device.
+        PointerEventArgs::DeviceKind deviceKind = PointerEventArgs::DeviceKind::UNKNOWN;
+
+        /// \brief The buttons pressed at the last event.
+        uint16_t buttons = 0;
+
+        /// \brief True if this is the primary pointer of its device kind.
+        bool isPrimary = false;
+
+        /// \brief The position at the last event.
+        glm::vec2 position;
+
+        /// \brief The timestamp of the last event in microseconds.
+        uint64_t timestampMicros = 0;
+    };
+
+    /// \returns the active pointers in no particular order.
+    ConstSpan<ActivePointer> activePointers() const;
+
+    /// \param pointerId The small pointer id of a dispatched event.
+    /// \returns the active pointer, or nullptr if the pointer is not active.
+    const ActivePointer* activePointer(std::size_t pointerId) const;
+
+    /// \brief The maximum number of simultaneously active pointers.
+    ///
+    /// Events of additional pointers are dispatched with their source
+    /// pointer id.
+    static const std::size_t MAX_ACTIVE_POINTERS = 64;
+
+    /// \brief Get the typed event for an event kind.
+    /// \param eventKind The event kind.
+    /// \returns the typed event, or nullptr for UNKNOWN and CUSTOM events.
+    ofEvent<PointerEventArgs>* typedEvent(PointerEventArgs::EventKind eventKind);
+
+protected:
+    /// \brief Dispatch the pointer events.
+    /// \param source The event source.
+    /// \param e the event arguments.
+    /// \returns true of the event was handled.
+    bool _dispatchPointerEvent(const void* source, PointerEventArgs& e);
+
+    /// \brief Notify the capture owner or broadcast the event.
+    /// \param e the event arguments.
+    /// \returns true of the event was handled.
+    bool _notifyPointerEvent(PointerEventArgs& e);
+
+    /// \brief Notify pointerEvent, the matching filtered events and the
+    /// matching typed event.
+    /// \param e the event arguments.
+    /// \returns true of the event was consumed.
+    bool _broadcastPointerEvent(PointerEventArgs& e);
+
+    /// \brief Queue an event for the next flush().
+    /// \param e the event arguments.
+    void _queuePointerEvent(const PointerEventArgs& e);
+
+    /// \brief Update the active pointer table with an event.
+    ///
+    /// Assigns the small pointer id and isPrimary to the event and its
+    /// samples. With frame batching, this happens in flush() right before
+    /// the event is delivered. As described in the Pointer Events specification, a mouse is
+    /// always primary, and other pointers are primary if no other pointer of
+    /// their device kind was active when they became active.
+    ///
+    /// Events of inactive pointers that can't make them active, such as a
+    /// late POINTER_UPDATE, reuse the id of their recently released pointer
+    /// if it was not reused yet, or get a new id that is released again
+    /// right away.
+    ///
+    /// If the table is full, the events of new pointers keep their source
+    /// pointer id.
+    ///
+    /// \param e the event arguments.
+    void _updateActivePointers(PointerEventArgs& e);
+
+    /// \brief Find the hash slot of a source pointer id.
+    /// \param sourcePointerId The source pointer id.
+    /// \returns the slot of the pointer id, or the empty slot where it
+    /// would be inserted.
+    std::size_t _findActivePointerSlot(std::size_t sourcePointerId) const;
+
+    /// \brief Remove the active pointer in a hash slot.
+    /// \param slot The hash slot.
+    void _removeActivePointer(std::size_t slot);
+
+    /// \returns the preferred hash slot of a source pointer id.
+    static std::size_t _toActivePointerSlot(std::size_t sourcePointerId);
+
+    /// \brief Apply the pending pointer capture of a pointer.
+    ///
+    /// Notifies the got and lost capture events as needed.
+    ///
+    /// \param e The event that is about to be dispatched for the pointer.
+    void _processPendingPointerCapture(const PointerEventArgs& e);
+
+    /// \brief Notify the owner of a capture and then broadcast the event.
+    /// \param callback The owner's callback.
+    /// \param e the capture event arguments.
+    void _notifyPointerCaptureEvent(PointerCaptureCallback& callback,
+                                    PointerEventArgs& e);
+
+    /// \brief Adapt a listener method that can consume events.
+    template <class ListenerClass>
+    static PointerCaptureCallback _toPointerCaptureCallback(ListenerClass* listener,
+                                                            bool (ListenerClass::*method)(PointerEventArgs&))
+    {
+        return [listener, method](PointerEventArgs& e) { return (listener->*method)(e); };
+    }
+
+    /// \brief Adapt a listener method that does not consume events.
+    template <class ListenerClass>
+    static PointerCaptureCallback _toPointerCaptureCallback(ListenerClass* listener,
+                                                            void (ListenerClass::*method)(PointerEventArgs&))
+    {
+        return [listener, method](PointerEventArgs& e) { (listener->*method)(e); return false; };
+    }
+
+    /// \brief Dispatch events and samples posted from other threads.
+    void _dispatchPostedEvents();
+
+    /// \brief True if the PointerEvents should consume mouse / touch events.
+    bool _consumeLegacyEvents = false;
+
+    /// \brief If true, the legacy events will be intercepted and converted to pointer events.
+    bool _interceptLegacyEvents = true;
+
+#if !defined(TARGET_OF_IOS) && !defined(TARGET_ANDROID)
+    /// \brief Mouse moved event listener.
+    ofEventListener _mouseMovedListener;
+
+    /// \brief Mouse dragged event listener.
+    ofEventListener _mouseDraggedListener;
+
+    /// \brief Mouse pressed event listener.
+    ofEventListener _mousePressedListener;
+
+    /// \brief Mouse released event listener.
+    ofEventListener _mouseReleasedListener;
+
+    /// \brief Mouse scrolled event listener.
+    ofEventListener _mouseScrolledListener;
+
+    /// \brief Mouse entered the source window event listener.
+    ofEventListener _mouseEnteredListener;
+
+    /// \brief Mouse exited the source window event listener.
+    ofEventListener _mouseExitedListener;
+#endif
+
+    /// \brief Touch downevent listener.
+    ofEventListener _touchDownListener;
+
+    /// \brief Touch up event listener.
+    ofEventListener _touchUpListener;
+
+    /// \brief Touch moved event listener.
+    ofEventListener _touchMovedListener;
+
+    /// \brief Touch double tap event listener.
+    ofEventListener _touchDoubleTapListener;
+
+    /// \brief Touch cancelled event listener.
+    ofEventListener _touchCancelledListener;
+
+    /// \brief Key pressed event listener.
+    ofEventListener _keyPressedListener;
+
+    /// \brief Key released event listener.
+    ofEventListener _keyReleasedListener;
+
+    /// \brief Update event listener.
+    ofEventListener _updateListener;
+
+    /// \brief True if frame batching is enabled.
+    bool _isFrameBatchingEnabled = false;
+
+    /// \brief True while flush() is dispatching.
+    bool _isFlushing = false;
+
+    /// \brief Events queued by frame batching.
+    std::vector<PointerEventArgs> _queuedEvents;
+
+    /// \brief Events being dispatched by flush().
+    std::vector<PointerEventArgs> _flushedEvents;
+
+    /// \brief The capacity of each posted event queue.
+    std::size_t _postedEventCapacity = DEFAULT_POSTED_EVENT_CAPACITY;
+
+    /// \brief Events posted from other threads, or nullptr until the first
+    /// event is posted. Owned by this PointerEvents.
+    std::atomic<BoundedMPSCQueue<PointerEventArgs>*> _postedEvents { nullptr };
+
+    /// \brief Samples posted from other threads.
+    BoundedMPSCQueue<PointerSample> _postedSamples;
+
+    /// \brief Posted events and samples being sorted and dispatched.
+    std::vector<PointerEventArgs> _drainedEvents;
+
+    /// \brief A reusable event that posted events are popped into.
+    PointerEventArgs _poppedEvent;
+
+    /// \brief The number of events and samples posted successfully.
+    std::atomic<uint64_t> _postedEventCount { 0 };
+
+    /// \brief The number of events and samples dropped by a full queue.
+    std::atomic<uint64_t> _droppedEventCount { 0 };
+
+    /// \brief The modifier and mouse button state used for conversion.
+    PointerInputState _inputState;
+
+    /// \brief Left and right modifier keys that are currently pressed.
+    uint8_t _pressedModifierKeys = 0;
+
+    /// \brief The default source if the callback is missing.
+    ofAppBaseWindow* _source = nullptr;
+
+    /// \brief A reusable event that mouse and touch events are converted into.
+    PointerEventArgs _convertedEvent;
+
+    /// \brief True while _convertedEvent is being dispatched.
+    bool _isDispatchingConvertedEvent = false;
+
+    /// \brief The number of PointerEventArgs::EventKind values.
+    static const std::size_t NUM_EVENT_KINDS = static_cast<std::size_t>(PointerEventArgs::EventKind::CUSTOM) + 1;
+
+    /// \brief Typed events indexed by PointerEventArgs::EventKind.
+    ofEvent<PointerEventArgs>* _typedEvents[NUM_EVENT_KINDS];
+
+    /// \brief An event with the filter its events must match.
+    struct FilteredEvent
+    {
+        /// \brief The filter.
+        PointerEventFilter filter;
+
+        /// \brief The event.
+        ofEvent<PointerEventArgs> event;
+    };
+
+    /// \brief The filtered events in the order they were requested.
+    std::vector<std::unique_ptr<FilteredEvent>> _filteredEvents;
+
+    /// \brief The filtered events that accept each event kind.
+    std::vector<FilteredEvent*> _filteredEventsByKind[NUM_EVENT_KINDS];
+
+    /// \brief The owner and callback of a pointer capture.
+    struct PointerCapture
+    {
+        /// \brief The owner, or nullptr for a pending release.
+        const void* owner = nullptr;
+
+        /// \brief The callback that receives the pointer's events.
+        PointerCaptureCallback callback;
+    };
+
+    /// \brief The number of PointerEventArgs::DeviceKind values.
+    static const std::size_t NUM_DEVICE_KINDS = static_cast<std::size_t>(PointerEventArgs::DeviceKind::CUSTOM) + 1;
+
+    /// \brief The number of active pointer hash slots, a power of two.
+    static const std::size_t NUM_ACTIVE_POINTER_SLOTS = MAX_ACTIVE_POINTERS * 2;
+
+    /// \brief The active pointers, densely packed.
+    ActivePointer _activePointers[MAX_ACTIVE_POINTERS];
+
+    /// \brief The number of active pointers.
+    std::size_t _numActivePointers = 0;
+
+    /// \brief True if the table overflowed since a pointer was last removed.
+    bool _didActivePointersOverflow = false;
+
+    /// \brief The number of active pointers of each device kind.
+    std::size_t _numActivePointersByKind[NUM_DEVICE_KINDS] = { };
+
+    /// \brief A linear probing hash index from source pointer id to active
+    /// pointer.
+    ///
+    /// Each slot holds an index into _activePointers plus one, or 0 if empty.
+    uint8_t _activePointerSlots[NUM_ACTIVE_POINTER_SLOTS] = { };
+
+    /// \brief The index into _activePointers plus one for each small pointer
+    /// id, or 0 if the id is free.
+    uint8_t _activePointerIndices[MAX_ACTIVE_POINTERS] = { };
+
+    /// \brief A FIFO ring of free small pointer ids.
+    uint8_t _freePointerIds[MAX_ACTIVE_POINTERS];
+
+    /// \brief The position of the oldest free id in _freePointerIds.
+    std::size_t _freePointerIdsBegin = 0;
+
+    /// \brief The source pointer id that each small pointer id was last
+    /// given to.
+    std::size_t _lastSourcePointerIds[MAX_ACTIVE_POINTERS] = { };
+
+    /// \brief True for each small pointer id that was given out before.
+    bool _wasPointerIdUsed[MAX_ACTIVE_POINTERS] = { };
+
+    /// \brief The active pointer captures by pointer id.
+    std::map<std::size_t, PointerCapture> _pointerCaptures;
+
+    /// \brief Captures and releases that apply at the pointer's next event.
+    std::map<std::size_t, PointerCapture> _pendingPointerCaptures;
+
+};
+
+
+template <class ListenerClass>
+void PointerEvents::registerPointerEvents(ListenerClass* listener, int prio)
+{
+    ofAddListener(pointerDown, listener, &ListenerClass::onPointerDown, prio);
+    ofAddListener(pointerUp, listener, &ListenerClass::onPointerUp, prio);
+    ofAddListener(pointerMove, listener, &ListenerClass::onPointerMove, prio);
+    ofAddListener(pointerCancel, listener, &ListenerClass::onPointerCancel, prio);
+}
+
+
+template <class ListenerClass>
+void PointerEvents::unregisterPointerEvents(ListenerClass* listener, int prio)
+{
+    ofRemoveListener(pointerDown, listener, &ListenerClass::onPointerDown, prio);
+    ofRemoveListener(pointerUp, listener, &ListenerClass::onPointerUp, prio);
+    ofRemoveListener(pointerMove, listener, &ListenerClass::onPointerMove, prio);
+    ofRemoveListener(pointerCancel, listener, &ListenerClass::onPointerCancel, prio);
+}
+
+
+template <class ListenerClass>
+void PointerEvents::setPointerCapture(std::size_t pointerId, ListenerClass* listener)
+{
+    setPointerCapture(pointerId,
+                      listener,
+                      _toPointerCaptureCallback(listener, &ListenerClass::onPointerEvent));
+}
+
+
+/// \brief A background thread that captures pointer samples.
+///
+/// Some input devices deliver events on their own thread or must be polled,
+/// which ties event timestamps to the frame rate if it is done on the main
+/// thread. A PointerCaptureThread repeatedly calls a capture function on a
+/// dedicated thread and posts each captured sample to a PointerEvents with
+/// PointerEvents::postPointerSample(). The samples are dispatched in
+/// timestamp order on the next PointerEvents::flush().
+///
+/// Samples are stamped with EventArgs::nowMicros() as soon as the capture
+/// function returns them, unless the function reports that it set the
+/// timestamp itself. Devices with their own clock should convert it to the
+/// event clock, e.g. with EventArgs::toTimestampMicros().
+///
+/// When the capture function returns false, the thread sleeps for the idle
+/// time before calling it again, so a polling function does not occupy a core.
+class PointerCaptureThread
+{
+public:
+    /// \brief A function that captures one sample.
+    ///
+    /// The function may block while waiting for input, but should return
+    /// regularly so that the thread can be stopped.
+    ///
+    /// \param sample The sample to fill.
+    /// \param hasTimestamp Set to true if the sample's timestamp was set.
+    ///        It is false when the function is called.
+    /// \returns true if a sample was captured.
+    typedef std::function<bool(PointerSample& sample, bool& hasTimestamp)> CaptureFunction;
+
+    /// \brief The default time to sleep when no sample was captured.
+    static const uint64_t DEFAULT_IDLE_SLEEP_MICROS = 500;
+
+    /// \brief Create a stopped PointerCaptureThread.
+    /// \param events The PointerEvents to post samples to. It must outlive
+    /// the thread.
+    /// \param capture The capture function.
+    /// \param idleSleepMicros The time to sleep when no sample was captured.
+    PointerCaptureThread(PointerEvents* events,
+                         CaptureFunction capture,
+                         uint64_t idleSleepMicros = DEFAULT_IDLE_SLEEP_MICROS);
+
+    /// \brief Stop the thread and destroy the PointerCaptureThread.
+    ~PointerCaptureThread();
+
+    PointerCaptureThread(const PointerCaptureThread&) = delete;
+    PointerCaptureThread& operator = (const PointerCaptureThread&) = delete;
+
+    /// \brief Start capturing if not already running.
+    void start();
+
+    /// \brief Stop capturing and wait for the capture function to return.
+    void stop();
+
+    /// \returns true if the thread is running.
+    bool isRunning() const;
+
+private:
+    /// \brief The capture loop.
+    void _run();
+
+    /// \brief The PointerEvents to post samples to.
+    PointerEvents* _events = nullptr;
+
+    /// \brief The capture function.
+    CaptureFunction _capture;
+
+    /// \brief The time to sleep when no sample was captured.
+    uint64_t _idleSleepMicros = DEFAULT_IDLE_SLEEP_MICROS;
+
+    /// \brief The capture thread.
+    std::thread _thread;
+
+    /// \brief True while the thread should keep capturing.
+    std::atomic<bool> _isRunning { false };
+
+};
+
+
+/// \brief A registry of rectangular pointer targets.
+///
+/// Targets are kept in a uniform grid, so resolving an event to the targets
+/// under it only visits the grid cells it overlaps. The hit area of an event
+/// is its position expanded by the axis-aligned bounds of its PointShape.
+/// Candidates are then tested against the PointShape itself, so fat touches
+/// hit exactly the targets their contact area overlaps.
+///
+/// The registry listens to the pointerEvent of a PointerEvents. Each event is
+/// delivered to the targets under it, topmost first, until a target consumes
+/// it. Before that, the registry generates boundary events for each pointer:
+///
+///     - POINTER_OUT and POINTER_OVER when the topmost target changes.
+///     - POINTER_LEAVE and POINTER_ENTER for each target the pointer stops or
+///       starts hitting.
+///
+/// Pointers that cannot hover (i.e. everything but mice) leave all targets
+/// after POINTER_UP. All pointers leave all targets after POINTER_CANCEL and
+/// when they leave the source window.
+///
+/// While a pointer is captured with PointerEvents::setPointerCapture(), its
+/// events go to the capture owner only. The targets under the pointer don't
+/// receive them and no boundary events are generated, so the pointer stays
+/// over the targets it was over when it was captured. The registry follows
+/// the captured pointer through PointerEvents::capturedPointerEvent, and
+/// the pointer still leaves all targets when it is lifted, cancelled or
+/// leaves the source window. After the capture is released, the next event
+/// of the pointer generates the boundary events for its new position.
+///
+/// Targets are ordered by z-index, then by the order they were added, with
+/// later targets on top.
+class PointerTargets
+{
+public:
+    /// \brief A function that receives the events of a target.
+    /// \param e the event arguments.
+    /// \returns true if the event was consumed.
+    typedef std::function<bool(PointerEventArgs& e)> Callback;
+
+    /// \brief Create a PointerTargets.
+    /// \param events The PointerEvents to listen to, or nullptr to feed
+    /// events with onPointerEvent().
+    /// \param cellSize The grid cell size in screen coordinates.
+    /// \param prio The pointerEvent listener priority.
+    PointerTargets(PointerEvents* events,
+                   float cellSize = DEFAULT_CELL_SIZE,
+                   int prio = OF_EVENT_ORDER_AFTER_APP);
+
+    /// \brief Destroy the PointerTargets.
+    ~PointerTargets();
+
+    PointerTargets(const PointerTargets&) = delete;
+    PointerTargets& operator = (const PointerTargets&) = delete;
+
+    /// \brief Add a target.
+    /// \param bounds The target bounds in screen coordinates.
+    /// \param callback The function that receives the target's events.
+    /// \param zIndex The z-index. Targets with a higher z-index are on top.
+    /// \returns the target id. Ids of removed targets are reused.
+    std::size_t addTarget(const ofRectangle& bounds,
+                          Callback callback,
+                          int zIndex = 0);
+
+    /// \brief Remove a target.
+    ///
+    /// The target does not receive any further events.
+    ///
+    /// \param targetId The target id.
+    void removeTarget(std::size_t targetId);
+
+    /// \brief Move or resize a target.
+    ///
+    /// Boundary events are generated by the next event of each pointer.
+    ///
+    /// \param targetId The target id.
+    /// \param bounds The new target bounds in screen coordinates.
+    void setTargetBounds(std::size_t targetId, const ofRectangle& bounds);
+
+    /// \param targetId The target id.
+    /// \returns the target bounds.
+    ofRectangle targetBounds(std::size_t targetId) const;
+
+    /// \returns the number of targets.
+    std::size_t size() const;
+
+    /// \brief Find the targets that intersect an area.
+    /// \param area The area in screen coordinates.
+    /// \param targetIds The matching target ids, topmost first.
+    void hitTest(const ofRectangle& area, std::vector<std::size_t>& targetIds) const;
+
+    /// \brief Find the targets under an event.
+    ///
+    /// Candidates from the hit area are refined with the event's PointShape,
+    /// so an ellipse only hits the targets it actually overlaps.
+    ///
+    /// \param e The event to test.
+    /// \param targetIds The matching target ids, topmost first.
+    void hitTest(const PointerEventArgs& e, std::vector<std::size_t>& targetIds) const;
+
+    /// \param e The event.
+    /// \returns the axis-aligned hit area of the event.
+    static ofRectangle hitArea(const PointerEventArgs& e);
+
+    /// \brief Pointer event callback.
+    /// \param e the event arguments.
+    /// \returns true if a target consumed the event.
+    bool onPointerEvent(PointerEventArgs& e);
+
+    /// \brief Captured pointer event callback.
+    ///
+    /// Updates the boundary state of a captured pointer without delivering
+    /// the event to any target.
+    ///
+    /// \param e the event arguments.
+    void onCapturedPointerEvent(PointerEventArgs& e);
+
+    /// \brief The default grid cell size.
+    static const float DEFAULT_CELL_SIZE;
+
+    /// \brief Targets that cover more cells than this are not gridded.
+    static const std::size_t MAX_CELLS_PER_TARGET = 64;
+
+private:
+    /// \brief A target.
+    struct Target
+    {
+        /// \brief The standardized bounds.
+        ofRectangle bounds;
+
+        /// \brief The callback.
+        Callback callback;
+
+        /// \brief The z-index.
+        int zIndex = 0;
+
+        /// \brief The insertion order, used to order equal z-indices.
+        uint64_t order = 0;
+
+        /// \brief True if the target is not in the grid.
+        bool isLarge = false;
+
+        /// \brief True if the slot holds a target.
+        bool isAlive = false;
+
+        /// \brief The last hit test that visited the target.
+        mutable uint64_t queryStamp = 0;
+    };
+
+    /// \brief The boundary state of a pointer.
+    struct PointerState
+    {
+        /// \brief The topmost target under the pointer, if any.
+        std::size_t topTargetId = NO_TARGET;
+
+        /// \brief The targets under the pointer, topmost first.
+        std::vector<std::size_t> targetIds;
+    };
+
+    /// \brief No target.
+    static const std::size_t NO_TARGET = std::numeric_limits<std::size_t>::max();
+
+    /// \brief Update the boundary state of the pointer of an event.
+    /// \param e the event arguments.
+    /// \param targetIds The targets now under the pointer, topmost first.
+    void _updatePointerState(const PointerEventArgs& e,
+                             const std::vector<std::size_t>& targetIds);
+
+    /// \brief Deliver a boundary event to a target.
+    ///
+    /// Boundary events carry no coalesced or predicted samples.
+    ///
+    /// \param targetId The target id.
+    /// \param eventKind The boundary event kind.
+    /// \param e The event that caused it.
+    void _notifyBoundaryEvent(std::size_t targetId,
+                              PointerEventArgs::EventKind eventKind,
+                              const PointerEventArgs& e);
+
+    /// \brief Deliver an event to a target.
+    /// \param targetId The target id.
+    /// \param e the event arguments.
+    /// \returns true if the target consumed the event.
+    bool _notifyTarget(std::size_t targetId, PointerEventArgs& e);
+
+    /// \brief Add a target to the grid.
+    void _insert(std::size_t targetId);
+
+    /// \brief Remove a target from the grid.
+    void _erase(std::size_t targetId);
+
+    /// \brief Get the grid cell range of an area.
+    void _toCells(const ofRectangle& area,
+                  int64_t& x0,
+                  int64_t& y0,
+                  int64_t& x1,
+                  int64_t& y1) const;
+
+    /// \returns the grid key of a cell.
+    static uint64_t _toKey(int64_t x, int64_t y);
+
+    /// \returns true if a is above b.
+    bool _isAbove(std::size_t a, std::size_t b) const;
+
+    /// \brief The pointerEvent listener.
+    ofEventListener _pointerEventListener;
+
+    /// \brief The capturedPointerEvent listener.
+    ofEventListener _capturedPointerEventListener;
+
+    /// \brief The grid cell size.
+    float _cellSize = DEFAULT_CELL_SIZE;
+
+    /// \brief Target slots indexed by target id.
+    std::vector<Target> _targets;
+
+    /// \brief Unused target slots.
+    std::vector<std::size_t> _freeTargetIds;
+
+    /// \brief The grid cells and the targets that overlap them.
+    std::unordered_map<uint64_t, std::vector<std::size_t>> _cells;
+
+    /// \brief Targets that are too large for the grid.
+    std::vector<std::size_t> _largeTargetIds;
+
+    /// \brief The boundary state of each pointer.
+    std::map<std::size_t, PointerState> _pointerStates;
+
+    /// \brief Reusable storage for the targets under the current event.
+    std::vector<std::size_t> _targetIds;
+
+    /// \brief Reusable storage for the targets previously under a pointer.
+    std::vector<std::size_t> _previousTargetIds;
+
+    /// \brief A reusable event that boundary events are assigned into.
+    PointerEventArgs _boundaryEvent;
+
+    /// \brief True while _boundaryEvent is being delivered.
+    bool _isNotifyingBoundaryEvent = false;
+
+    /// \brief The number of targets.
+    std::size_t _size = 0;
+
+    /// \brief The next insertion order.
+    uint64_t _nextOrder = 0;
+
+    /// \brief The current hit test.
+    mutable uint64_t _queryStamp = 0;
+
+};
+
+
+/// \brief Manages PointerEvents objects based on their ofAppBaseWindow source.
+class PointerEventsManager
+{
+public:
+    /// \returns a PointerEvents instance registered to listen to the global events or nullptr.
+    PointerEvents* events();
+
+    /// \returns a PointerEvents instance registered to listen to the given window or nullptr.
+    PointerEvents* eventsForWindow(ofAppBaseWindow* window);
+
+    /// \brief Get the singleton instance of the PointerEventsManager.
+    /// \returns an instance of PointerEventsManager.
+    static PointerEventsManager& instance();
+
+private:
+    /// \brief Create a default PointerEventsManager object.
+    PointerEventsManager();
+
+    /// \brief Destroy the PointerEventsManager.
+    ~PointerEventsManager();
+
+    /// \brief A map of windows to their pointer events.
+    std::map<ofAppBaseWindow*, std::unique_ptr<PointerEvents>> _windowEventMap;
+
+};
+
+
+template <class ListenerClass>
+void RegisterPointerEventsForWindow(ofAppBaseWindow* window, ListenerClass* listener, int prio = OF_EVENT_ORDER_AFTER_APP)
+{
+    PointerEvents* events = PointerEventsManager::instance().eventsForWindow(window);
+
+    if (events)
+    {
+        events->registerPointerEvents(listener, prio);
+    }
+    else
+    {
+        ofLogError("RegisterPointerEventsForWindow") << "No PointerEvents available for given window.";
+    }
+}
+
+
+template <class ListenerClass>
+void UnregisterPointerEventsForWindow(ofAppBaseWindow* window, ListenerClass* listener, int prio = OF_EVENT_ORDER_AFTER_APP)
+{
+    PointerEvents* events = PointerEventsManager::instance().eventsForWindow(window);
+
+    if (events)
+    {
+        events->unregisterPointerEvents(listener, prio);
+    }
+    else
+    {
+        ofLogError("UnregisterPointerEventsForWindow") << "No PointerEvents available for given window.";
+    }
+}
+
+
+template <class ListenerClass>
+void RegisterPointerEvents(ListenerClass* listener, int prio = OF_EVENT_ORDER_AFTER_APP)
+{
+    RegisterPointerEventsForWindow<ListenerClass>(ofGetWindowPtr(), listener, prio);
+}
+
+
+template <class ListenerClass>
+void UnregisterPointerEvents(ListenerClass* listener, int prio = OF_EVENT_ORDER_AFTER_APP)
+{
+    UnregisterPointerEventsForWindow<ListenerClass>(ofGetWindowPtr(), listener, prio);
+}
+
+
+template <class ListenerClass>
+void RegisterPointerEventForWindow(ofAppBaseWindow* window, ListenerClass* listener, int prio = OF_EVENT_ORDER_AFTER_APP)
+{
+    PointerEvents* events = PointerEventsManager::instance().eventsForWindow(window);
+
+    if (events)
+    {
+        ofAddListener(events->pointerEvent, listener, &ListenerClass::onPointerEvent, prio);
+    }
+    else
+    {
+        ofLogError("RegisterPointerEventForWindow") << "No PointerEvents available for given window.";
+    }
+}
+
+
+template <class ListenerClass>
+void UnregisterPointerEventForWindow(ofAppBaseWindow* window, ListenerClass* listener, int prio = OF_EVENT_ORDER_AFTER_APP)
+{
+    PointerEvents* events = PointerEventsManager::instance().eventsForWindow(window);
+
+    if (events)
+    {
+        ofRemoveListener(events->pointerEvent, listener, &ListenerClass::onPointerEvent, prio);
+    }
+    else
+    {
+        ofLogError("UnregisterPointerEventForWindow") << "No PointerEvents available for given window.";
+    }
+}
+
+
+template <class ListenerClass>
+void RegisterPointerEventForWindow(ofAppBaseWindow* window, const PointerEventFilter& filter, ListenerClass* listener, int prio = OF_EVENT_ORDER_AFTER_APP)
+{
+    PointerEvents* events = PointerEventsManager::instance().eventsForWindow(window);
+
+    if (events)
+    {
+        ofAddListener(events->filteredEvent(filter), listener, &ListenerClass::onPointerEvent, prio);
+    }
+    else
+    {
+        ofLogError("RegisterPointerEventForWindow") << "No PointerEvents available for given window.";
+    }
+}
+
+
+template <class ListenerClass>
+void UnregisterPointerEventForWindow(ofAppBaseWindow* window, const PointerEventFilter& filter, ListenerClass* listener, int prio = OF_EVENT_ORDER_AFTER_APP)
+{
+    PointerEvents* events = PointerEventsManager::instance().eventsForWindow(window);
+
+    if (events)
+    {
+        ofRemoveListener(events->filteredEvent(filter), listener, &ListenerClass::onPointerEvent, prio);
+    }
+    else
+    {
+        ofLogError("UnregisterPointerEventForWindow") << "No PointerEvents available for given window.";
+    }
+}
+
+
+template <class ListenerClass>
+void RegisterPointerEvent(ListenerClass* listener, int prio = OF_EVENT_ORDER_AFTER_APP)
+{
+    RegisterPointerEventForWindow<ListenerClass>(ofGetWindowPtr(), listener, prio);
+}
+
+
+template <class ListenerClass>
+void UnregisterPointerEvent(ListenerClass* listener, int prio = OF_EVENT_ORDER_AFTER_APP)
+{
+    UnregisterPointerEventForWindow<ListenerClass>(ofGetWindowPtr(), listener, prio);
+}
+
+
+template <class ListenerClass>
+void RegisterPointerEvent(const PointerEventFilter& filter, ListenerClass* listener, int prio = OF_EVENT_ORDER_AFTER_APP)
+{
+    RegisterPointerEventForWindow<ListenerClass>(ofGetWindowPtr(), filter, listener, prio);
+}
+
+
+template <class ListenerClass>
+void UnregisterPointerEvent(const PointerEventFilter& filter, ListenerClass* listener, int prio = OF_EVENT_ORDER_AFTER_APP)
+{
+    UnregisterPointerEventForWindow<ListenerClass>(ofGetWindowPtr(), filter, listener, prio);
+}
+
+
+/// \brief A structure-of-arrays container of PointerSamples.
+///
+/// Each PointerSample member is stored in its own contiguous column so that
+/// loops over a single property (e.g. x(), y() or pressure()) are cache
+/// friendly and can be auto-vectorized. Azimuth and altitude are derived from
+/// the tilt columns in batches as samples are added.
+class PointerSampleColumns
+{
+public:
+    /// \brief An iterator that yields PointerSamples by value.
+    class ConstIterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef PointerSample value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const PointerSample* pointer;
+        typedef PointerSample reference;
+
+        /// \brief Create an iterator.
+        /// \param columns The columns to iterate.
+        /// \param index The current index.
+        ConstIterator(const PointerSampleColumns* columns, std::size_t index):
+            _columns(columns),
+            _index(index)
+        {
+        }
+
+        PointerSample operator * () const
+        {
+            return (*_columns)[_index];
+        }
+
+        ConstIterator& operator ++ ()
+        {
+            ++_index;
+            return *this;
+        }
+
+        ConstIterator operator ++ (int)
+        {
+            ConstIterator result(*this);
+            ++_index;
+            return result;
+        }
+
+        bool operator == (const ConstIterator& other) const
+        {
+            return _columns == other._columns && _index == other._index;
+        }
+
+        bool operator != (const ConstIterator& other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        const PointerSampleColumns* _columns = nullptr;
+        std::size_t _index = 0;
+
+    };
+
+    /// \brief Create empty PointerSampleColumns.
+    PointerSampleColumns();
+
+    /// \brief Destroy the PointerSampleColumns.
+    ~PointerSampleColumns();
+
+    PointerSampleColumns(const PointerSampleColumns&) = default;
+    PointerSampleColumns(PointerSampleColumns&&) = default;
+    PointerSampleColumns& operator = (const PointerSampleColumns&) = default;
+    PointerSampleColumns& operator = (PointerSampleColumns&&) = default;
+
+    /// \returns the number of samples.
+    std::size_t size() const;
+
+    /// \returns true if size() == 0.
+    bool empty() const;
+
+    /// \brief Remove all samples.
+    void clear();
+
+    /// \brief Reserve space in all columns.
+    /// \param size The number of samples to reserve space for.
+    void reserve(std::size_t size);
+
+    /// \returns the number of samples that fit without reallocating.
+    std::size_t capacity() const;
+
+    /// \brief Add a sample to the end of all columns.
+    /// \param sample The sample to add.
+    void push_back(const PointerSample& sample);
+
+    /// \brief Add samples of the given events to the end of all columns.
+    /// \param events The events to add.
+    void append(ConstSpan<PointerEventArgs> events);
+
+    /// \brief Reduce the number of samples.
+    /// \param size The new size. Must be <= size().
+    void truncate(std::size_t size);
+
+    /// \brief Remove samples from the front.
+    ///
+    /// Removed samples are skipped rather than moved. The remaining samples
+    /// are moved to the front of the storage once the skipped samples
+    /// outnumber them, so the cost is amortized O(1) per removed sample and
+    /// the storage never needs more than twice the largest size.
+    ///
+    /// \param count The number of samples to remove. Must be <= size().
+    void eraseFront(std::size_t count);
+
+    /// \brief Remove all samples with any of the given PointerSample::Flag bits.
+    ///
+    /// The order of the remaining samples is preserved.
+    ///
+    /// \param flags The PointerSample::Flag bits to match.
+    void eraseFlagged(uint8_t flags);
+
+    /// \brief Replace the sample at the given index.
+    /// \param index The index of the sample. Must be < size().
+    /// \param sample The new sample.
+    void set(std::size_t index, const PointerSample& sample);
+
+    /// \brief Assemble the sample at the given index.
+    /// \param index The index of the sample. Must be < size().
+    /// \returns the sample.
+    PointerSample operator [] (std::size_t index) const;
+
+    /// \returns the first sample. Must not be empty.
+    PointerSample front() const;
+
+    /// \returns the last sample. Must not be empty.
+    PointerSample back() const;
+
+    /// \returns an iterator to the first sample.
+    ConstIterator begin() const;
+
+    /// \returns an iterator past the last sample.
+    ConstIterator end() const;
+
+    /// \returns the position x column.
+    ConstSpan<float> x() const;
+
+    /// \returns the position y column.
+    ConstSpan<float> y() const;
+
+    /// \returns the precise position x column.
+    ConstSpan<float> preciseX() const;
+
+    /// \returns the precise position y column.
+    ConstSpan<float> preciseY() const;
+
+    /// \returns the pressure column.
+    ConstSpan<float> pressure() const;
+
+    /// \returns the twist column in degrees.
+    ConstSpan<float> twistDeg() const;
+
+    /// \returns the tilt x column in degrees.
+    ConstSpan<float> tiltXDeg() const;
+
+    /// \returns the tilt y column in degrees.
+    ConstSpan<float> tiltYDeg() const;
+
+    /// \returns the azimuth column in degrees.
+    /// \sa Point::azimuthDeg()
+    ConstSpan<float> azimuthDeg() const;
+
+    /// \returns the altitude column in degrees.
+    /// \sa Point::altitudeDeg()
+    ConstSpan<float> altitudeDeg() const;
+
+    /// \brief Get the cumulative arc length column in pixels.
+    ///
+    /// Each value is the arc length of the first sample plus the length of
+    /// the polyline through the positions up to the sample. It is updated
+    /// from the first changed sample when samples are added, set or erased.
+    /// Samples erased from the front do not change the remaining values, so
+    /// the first value is the length of the erased part. The values are
+    /// double precision so that long bounded strokes keep sub-pixel steps.
+    ///
+    /// \returns the arc length column.
+    ConstSpan<double> arcLength() const;
+
+    /// \returns the timestamp column in microseconds.
+    ConstSpan<uint64_t> timestampMicros() const;
+
+    /// \returns the pointer id column.
+    ConstSpan<uint64_t> pointerId() const;
+
+    /// \returns the sequence index column.
+    ConstSpan<uint64_t> sequenceIndex() const;
+
+    /// \returns the buttons column.
+    ConstSpan<uint16_t> buttons() const;
+
+    /// \returns the event kind column.
+    ConstSpan<PointerEventArgs::EventKind> eventKind() const;
+
+    /// \returns the device kind column.
+    ConstSpan<PointerEventArgs::DeviceKind> deviceKind() const;
+
+    /// \returns the PointerSample::Flag column.
+    ConstSpan<uint8_t> flags() const;
+
+    /// \returns the estimated PointerEventArgs::PropertyFlag column.
+    ConstSpan<uint8_t> estimatedPropertyFlags() const;
+
+    /// \returns the estimated PointerEventArgs::PropertyFlag column for properties expecting updates.
+    ConstSpan<uint8_t> estimatedPropertyFlagsExpectingUpdates() const;
+
+private:
+    /// \brief Add a sample to the end of all columns except azimuth and altitude.
+    /// \param sample The sample to add.
+    void _push_back(const PointerSample& sample);
+
+    /// \brief Calculate azimuth and altitude for samples starting at first.
+    /// \param first The index of the first sample to calculate.
+    void _updateAzimuthAltitude(std::size_t first);
+
+    /// \brief Calculate arc lengths for samples starting at first.
+    /// \param first The index of the first sample to calculate.
+    void _updateArcLength(std::size_t first);
+
+    /// \brief Copy all columns of one sample to another index.
+    /// \param to The destination storage index.
+    /// \param from The source storage index.
+    void _copy(std::size_t to, std::size_t from);
+
+    /// \brief The storage index of the first sample.
+    std::size_t _begin = 0;
+
+    std::vector<float> _x;
+    std::vector<float> _y;
+    std::vector<float> _preciseX;
+    std::vector<float> _preciseY;
+    std::vector<float> _pressure;
+    std::vector<float> _twistDeg;
+    std::vector<float> _tiltXDeg;
+    std::vector<float> _tiltYDeg;
+    std::vector<float> _azimuthDeg;
+    std::vector<float> _altitudeDeg;
+    std::vector<double> _arcLength;
+    std::vector<uint64_t> _timestampMicros;
+    std::vector<uint64_t> _pointerId;
+    std::vector<uint64_t> _sequenceIndex;
+    std::vector<uint16_t> _buttons;
+    std::vector<PointerEventArgs::EventKind> _eventKind;
+    std::vector<PointerEventArgs::DeviceKind> _deviceKind;
+    std::vector<uint8_t> _flags;
+    std::vector<uint8_t> _estimatedPropertyFlags;
+    std::vector<uint8_t> _estimatedPropertyFlagsExpectingUpdates;
+
+};
+
+
+/// \brief A hash map from update sequence index to sample position.
+///
+/// The map uses open addressing with linear probing in a single array of
+/// slots, so entries are not allocated individually. The slots are only
+/// reallocated when the map grows beyond the size it was reserved for.
+/// Sequence index 0 means the sample can't be updated and is not a valid key.
+class PointerSequenceIndexMap
+{
+public:
+    /// \brief Create an empty map.
+    PointerSequenceIndexMap();
+
+    /// \brief Destroy the map.
+    ~PointerSequenceIndexMap();
 
-protected:
-    /// \brief Dispatch the pointer events.
-    /// \param source The event source.
-    /// \param e the event arguments.
-    /// \returns true of the event was handled.
-    bool _dispatchPointerEvent(const void* source, PointerEventArgs& e);
+    PointerSequenceIndexMap(const PointerSequenceIndexMap&) = default;
+    PointerSequenceIndexMap(PointerSequenceIndexMap&&) = default;
+    PointerSequenceIndexMap& operator = (const PointerSequenceIndexMap&) = default;
+    PointerSequenceIndexMap& operator = (PointerSequenceIndexMap&&) = default;
 
-    /// \brief True if the PointerEvents should consume mouse / touch events.
-    bool _consumeLegacyEvents = false;
+    /// \brief Reserve slots so that size entries can be set without
+    /// reallocating.
+    /// \param size The number of entries to reserve for.
+    void reserve(std::size_t size);
 
-    /// \brief If true, the legacy events will be intercepted and converted to pointer events.
-    bool _interceptLegacyEvents = true;
+    /// \param sequenceIndex The sequence index to look up.
+    /// \returns a pointer to the position, or nullptr if there is none.
+    const uint64_t* find(uint64_t sequenceIndex) const;
 
-#if !defined(TARGET_OF_IOS) && !defined(TARGET_ANDROID)
-    /// \brief Mouse moved event listener.
-    ofEventListener _mouseMovedListener;
+    /// \brief Set the position of a sequence index.
+    /// \param sequenceIndex The sequence index. Must not be 0.
+    /// \param position The position.
+    void set(uint64_t sequenceIndex, uint64_t position);
 
-    /// \brief Mouse dragged event listener.
-    ofEventListener _mouseDraggedListener;
+    /// \brief Erase a sequence index.
+    /// \param sequenceIndex The sequence index to erase.
+    void erase(uint64_t sequenceIndex);
 
-    /// \brief Mouse pressed event listener.
-    ofEventListener _mousePressedListener;
+    /// \brief Erase a sequence index if it has the given position.
+    /// \param sequenceIndex The sequence index to erase.
+    /// \param position The position it must have.
+    void erase(uint64_t sequenceIndex, uint64_t position);
 
-    /// \brief Mouse released event listener.
-    ofEventListener _mouseReleasedListener;
+    /// \brief Remove all entries, keeping the slots.
+    void clear();
 
-    /// \brief Mouse scrolled event listener.
-    ofEventListener _mouseScrolledListener;
+    /// \returns the number of entries.
+    std::size_t size() const;
 
-    /// \brief Mouse entered the source window event listener.
-    ofEventListener _mouseEnteredListener;
+    /// \returns true if size() == 0.
+    bool empty() const;
 
-    /// \brief Mouse exited the source window event listener.
-    ofEventListener _mouseExitedListener;
-#endif
+private:
+    struct Slot
+    {
+        /// \brief The key, or 0 if the slot is empty.
+        uint64_t sequenceIndex = 0;
 
-    /// \brief Touch downevent listener.
-    ofEventListener _touchDownListener;
+        /// \brief The value.
+        uint64_t position = 0;
+    };
 
-    /// \brief Touch up event listener.
-    ofEventListener _touchUpListener;
+    /// \brief Find the slot of a sequence index, or the empty slot that
+    /// ends its probe sequence.
+    /// \param sequenceIndex The sequence index.
+    /// \returns the slot index. Slots must not be empty.
+    std::size_t _findSlot(uint64_t sequenceIndex) const;
 
-    /// \brief Touch moved event listener.
-    ofEventListener _touchMovedListener;
+    /// \brief Erase the entry in a slot.
+    /// \param slot The slot index.
+    void _eraseSlot(std::size_t slot);
 
-    /// \brief Touch double tap event listener.
-    ofEventListener _touchDoubleTapListener;
+    /// \brief Move all entries to the given number of slots.
+    /// \param numSlots The new number of slots, a power of two.
+    void _rehash(std::size_t numSlots);
 
-    /// \brief Touch cancelled event listener.
-    ofEventListener _touchCancelledListener;
+    /// \brief The slots, a power of two in number, at most half full.
+    std::vector<Slot> _slots;
 
-    /// \brief The default source if the callback is missing.
-    ofAppBaseWindow* _source = nullptr;
+    /// \brief The number of entries.
+    std::size_t _size = 0;
 
 };
 
 
-template <class ListenerClass>
-void PointerEvents::registerPointerEvents(ListenerClass* listener, int prio)
+/// \brief Incrementally simplifies a sequence of committed samples.
+///
+/// Samples are added one at a time and a subset of them is retained. A
+/// discarded sample is within tolerance of the segment between the retained
+/// samples before and after it, and its pressure is within pressureTolerance
+/// of the pressure interpolated along that segment.
+///
+/// This is a sliding window form of Ramer-Douglas-Peucker simplification. The
+/// samples since the last retained sample are kept in a window. Each new
+/// sample is tested against the window, and if any window sample would exceed
+/// the tolerances, the previous sample is retained and starts a new window.
+/// The newest sample is always the last of samples(), and is replaced while
+/// it extends the window.
+///
+/// Retained and windowed samples still accept POINTER_UPDATE events. Updates
+/// do not revisit earlier decisions to discard samples.
+class PointerStrokeSimplifier
 {
-    ofAddListener(pointerDown, listener, &ListenerClass::onPointerDown, prio);
-    ofAddListener(pointerUp, listener, &ListenerClass::onPointerUp, prio);
-    ofAddListener(pointerMove, listener, &ListenerClass::onPointerMove, prio);
-    ofAddListener(pointerCancel, listener, &ListenerClass::onPointerCancel, prio);
-}
+public:
+    struct Settings;
 
+    /// \brief Create a simplifier with default settings.
+    PointerStrokeSimplifier();
 
-template <class ListenerClass>
-void PointerEvents::unregisterPointerEvents(ListenerClass* listener, int prio)
-{
-    ofRemoveListener(pointerDown, listener, &ListenerClass::onPointerDown, prio);
-    ofRemoveListener(pointerUp, listener, &ListenerClass::onPointerUp, prio);
-    ofRemoveListener(pointerMove, listener, &ListenerClass::onPointerMove, prio);
-    ofRemoveListener(pointerCancel, listener, &ListenerClass::onPointerCancel, prio);
-}
+    /// \brief Create a simplifier with the given settings.
+    /// \param settings The settings to use.
+    PointerStrokeSimplifier(const Settings& settings);
 
+    /// \brief Destroy the simplifier.
+    ~PointerStrokeSimplifier();
 
-/// \brief Manages PointerEvents objects based on their ofAppBaseWindow source.
-class PointerEventsManager
-{
-public:
-    /// \returns a PointerEvents instance registered to listen to the global events or nullptr.
-    PointerEvents* events();
+    PointerStrokeSimplifier(const PointerStrokeSimplifier&) = default;
+    PointerStrokeSimplifier(PointerStrokeSimplifier&&) = default;
+    PointerStrokeSimplifier& operator = (const PointerStrokeSimplifier&) = default;
+    PointerStrokeSimplifier& operator = (PointerStrokeSimplifier&&) = default;
 
-    /// \returns a PointerEvents instance registered to listen to the given window or nullptr.
-    PointerEvents* eventsForWindow(ofAppBaseWindow* window);
+    /// \brief Add the next committed sample.
+    /// \param sample The sample to add.
+    void add(const PointerSample& sample);
 
-    /// \brief Get the singleton instance of the PointerEventsManager.
-    /// \returns an instance of PointerEventsManager.
-    static PointerEventsManager& instance();
+    /// \brief Update a retained or windowed sample with a POINTER_UPDATE event.
+    /// \param e The update event.
+    /// \returns true if a sample with the same sequence index was found.
+    bool update(const PointerEventArgs& e);
 
-private:
-    /// \brief Create a default PointerEventsManager object.
-    PointerEventsManager();
+    /// \brief Drop retained samples that are older than a timestamp.
+    ///
+    /// The newest sample is never dropped. Dropped samples no longer accept
+    /// POINTER_UPDATE events.
+    ///
+    /// \param timestampMicros The timestamp of the oldest sample to keep.
+    void dropBefore(uint64_t timestampMicros);
 
-    /// \brief Destroy the PointerEventsManager.
-    ~PointerEventsManager();
+    /// \brief Reserve storage so that a bounded number of samples can be
+    /// kept without reallocating.
+    /// \param size The maximum number of samples kept at once.
+    void reserve(std::size_t size);
 
-    /// \brief A map of windows to their pointer events.
-    std::map<ofAppBaseWindow*, std::unique_ptr<PointerEvents>> _windowEventMap;
+    /// \brief Remove all samples, keeping the settings.
+    void clear();
 
-};
+    /// \returns the Settings.
+    const Settings& settings() const;
 
+    /// \returns the retained samples followed by the newest sample.
+    const PointerSampleColumns& samples() const;
 
-template <class ListenerClass>
-void RegisterPointerEventsForWindow(ofAppBaseWindow* window, ListenerClass* listener, int prio = OF_EVENT_ORDER_AFTER_APP)
-{
-    PointerEvents* events = PointerEventsManager::instance().eventsForWindow(window);
+    /// \returns the number of samples added since the last clear().
+    uint64_t numAddedSamples() const;
 
-    if (events)
-    {
-        events->registerPointerEvents(listener, prio);
-    }
-    else
+    struct Settings
     {
-        ofLogError("RegisterPointerEventsForWindow") << "No PointerEvents available for given window.";
-    }
-}
+        /// \brief The maximum distance of a discarded sample in pixels.
+        float tolerance = 1;
 
+        /// \brief The maximum pressure difference of a discarded sample.
+        float pressureTolerance = 0.02f;
 
-template <class ListenerClass>
-void UnregisterPointerEventsForWindow(ofAppBaseWindow* window, ListenerClass* listener, int prio = OF_EVENT_ORDER_AFTER_APP)
-{
-    PointerEvents* events = PointerEventsManager::instance().eventsForWindow(window);
+        /// \brief The maximum number of samples in the window.
+        ///
+        /// This bounds the cost of adding a sample. A full window retains
+        /// its newest sample.
+        std::size_t maxWindowSize = 64;
 
-    if (events)
-    {
-        events->unregisterPointerEvents(listener, prio);
-    }
-    else
-    {
-        ofLogError("UnregisterPointerEventsForWindow") << "No PointerEvents available for given window.";
-    }
-}
+    };
 
+private:
+    /// \brief Determine if a sample can replace the newest sample.
+    /// \param sample The candidate end of the window.
+    /// \returns true if all window samples are within tolerance.
+    bool _canExtendWindow(const PointerSample& sample) const;
 
-template <class ListenerClass>
-void RegisterPointerEvents(ListenerClass* listener, int prio = OF_EVENT_ORDER_AFTER_APP)
-{
-    RegisterPointerEventsForWindow<ListenerClass>(ofGetWindowPtr(), listener, prio);
-}
+    /// \brief Index a sample of samples() if it is expecting updates.
+    /// \param index The index in samples().
+    void _indexSample(std::size_t index);
 
+    /// \brief The Settings.
+    Settings _settings;
 
-template <class ListenerClass>
-void UnregisterPointerEvents(ListenerClass* listener, int prio = OF_EVENT_ORDER_AFTER_APP)
-{
-    UnregisterPointerEventsForWindow<ListenerClass>(ofGetWindowPtr(), listener, prio);
-}
+    /// \brief The retained samples followed by the newest sample.
+    PointerSampleColumns _samples;
 
+    /// \brief The last retained sample before the window.
+    PointerSample _anchor;
 
-template <class ListenerClass>
-void RegisterPointerEventForWindow(ofAppBaseWindow* window, ListenerClass* listener, int prio = OF_EVENT_ORDER_AFTER_APP)
-{
-    PointerEvents* events = PointerEventsManager::instance().eventsForWindow(window);
+    /// \brief The samples added since the anchor, newest last.
+    std::vector<PointerSample> _window;
 
-    if (events)
-    {
-        ofAddListener(events->pointerEvent, listener, &ListenerClass::onPointerEvent, prio);
-    }
-    else
-    {
-        ofLogError("RegisterPointerEventForWindow") << "No PointerEvents available for given window.";
-    }
-}
+    /// \brief The positions of samples expecting updates by sequence index.
+    ///
+    /// A position counts dropped samples, so it is the index in _samples
+    /// plus _numDroppedSamples.
+    PointerSequenceIndexMap _samplesExpectingUpdates;
 
+    /// \brief The number of samples added since the last clear().
+    uint64_t _numAddedSamples = 0;
 
-template <class ListenerClass>
-void UnregisterPointerEventForWindow(ofAppBaseWindow* window, ListenerClass* listener, int prio = OF_EVENT_ORDER_AFTER_APP)
+    /// \brief The number of samples dropped from the front of _samples.
+    uint64_t _numDroppedSamples = 0;
+
+};
+
+
+/// \brief Resamples a sequence of samples by arc length.
+///
+/// With a spacing, samples are placed at every multiple of the spacing along
+/// the cumulative arc length, so existing resampled samples stay in place as
+/// the stroke grows. Only the resampled samples at or after the arc length
+/// of the sample before the first changed sample are recalculated. With a
+/// count, the samples are spread evenly from the first to the last sample
+/// and are all recalculated after each change.
+///
+/// Resampled samples interpolate the position, precise position, pressure,
+/// twist, tilt and timestamp of the samples on either side. Their other
+/// properties are those of the earlier sample.
+class PointerStrokeResampler
 {
-    PointerEvents* events = PointerEventsManager::instance().eventsForWindow(window);
+public:
+    struct Settings;
 
-    if (events)
-    {
-        ofRemoveListener(events->pointerEvent, listener, &ListenerClass::onPointerEvent, prio);
-    }
-    else
+    /// \brief Create a resampler with default settings.
+    PointerStrokeResampler();
+
+    /// \brief Create a resampler with the given settings.
+    /// \param settings The settings to use.
+    PointerStrokeResampler(const Settings& settings);
+
+    /// \brief Destroy the resampler.
+    ~PointerStrokeResampler();
+
+    PointerStrokeResampler(const PointerStrokeResampler&) = default;
+    PointerStrokeResampler(PointerStrokeResampler&&) = default;
+    PointerStrokeResampler& operator = (const PointerStrokeResampler&) = default;
+    PointerStrokeResampler& operator = (PointerStrokeResampler&&) = default;
+
+    /// \brief Update the resampled samples after the source samples changed.
+    ///
+    /// Source samples before firstChangedIndex must not have moved since the
+    /// last update, except by erasing them from the front.
+    ///
+    /// \param samples The source samples.
+    /// \param firstChangedIndex The index of the first added or changed sample.
+    void update(const PointerSampleColumns& samples, std::size_t firstChangedIndex);
+
+    /// \brief Remove all resampled samples, keeping the settings.
+    void clear();
+
+    /// \returns the Settings.
+    const Settings& settings() const;
+
+    /// \returns the resampled samples.
+    const PointerSampleColumns& samples() const;
+
+    struct Settings
     {
-        ofLogError("UnregisterPointerEventForWindow") << "No PointerEvents available for given window.";
-    }
-}
+        /// \brief The arc length between resampled samples in pixels.
+        float spacing = 4;
 
+        /// \brief The number of resampled samples.
+        ///
+        /// If non-zero, the samples are resampled to this count and spacing is
+        /// ignored.
+        std::size_t count = 0;
 
+    };
 
-template <class ListenerClass>
-void RegisterPointerEvent(ListenerClass* listener, int prio = OF_EVENT_ORDER_AFTER_APP)
-{
-    RegisterPointerEventForWindow<ListenerClass>(ofGetWindowPtr(), listener, prio);
-}
+private:
+    /// \brief Add a sample at the given arc length.
+    /// \param samples The source samples.
+    /// \param index The index of a source sample at or before the arc length.
+    /// \param arcLength The arc length of the new sample.
+    /// \returns the index of the source sample at or before the arc length.
+    std::size_t _push_back(const PointerSampleColumns& samples,
+                           std::size_t index,
+                           double arcLength);
+
+    /// \brief The Settings.
+    Settings _settings;
 
+    /// \brief The resampled samples.
+    PointerSampleColumns _samples;
 
-template <class ListenerClass>
-void UnregisterPointerEvent(ListenerClass* listener, int prio = OF_EVENT_ORDER_AFTER_APP)
-{
-    UnregisterPointerEventForWindow<ListenerClass>(ofGetWindowPtr(), listener, prio);
-}
+    /// \brief The spacing multiple of the first resampled sample.
+    uint64_t _firstMultiple = 0;
+
+};
 
 
 /// \brief A PointerStroke is a collection of events with the same pointer id.
 ///
 /// A pointer stroke begins with a pointerdown event and ends with a pointerup
 /// or pointercancel event.
+///
+/// Samples are stored in two regions. Committed samples (coalesced samples,
+/// which include each event itself) are only ever appended. The predicted
+/// samples of the latest event follow them as a tail that is replaced by each
+/// new event, so adding an event costs time proportional to its own samples
+/// rather than the length of the stroke.
+///
+/// A bounded stroke keeps only its newest samples, limited by a sample
+/// capacity and optionally by a time window. Its storage is reserved when it
+/// is constructed, so memory use stays flat however long the stroke lasts.
 class PointerStroke
 {
 public:
-    /// \brief Construct a default PointerStroke.
+    /// \brief The sample rate assumed by capacityForWindow().
+    static const float DEFAULT_MAX_SAMPLE_RATE_HZ;
+
+    /// \brief Construct a default unbounded PointerStroke.
     PointerStroke();
 
+    /// \brief Construct a bounded PointerStroke.
+    ///
+    /// When full, the oldest committed samples are dropped to make room.
+    /// Committed samples that are older than the newest committed sample by
+    /// more than windowMicros are also dropped. Storage for 2 * capacity
+    /// samples and an update index for capacity samples is reserved, and is
+    /// not reallocated unless the stroke is copied.
+    ///
+    /// \param capacity The maximum number of samples, including predicted
+    ///        samples. Must be > 0.
+    /// \param windowMicros The maximum age of committed samples relative to
+    ///        the newest committed sample, or 0 for no time window.
+    PointerStroke(std::size_t capacity, uint64_t windowMicros = 0);
+
     /// \brief Destroy the PointerStroke.
     ~PointerStroke();
 
+    PointerStroke(const PointerStroke&) = default;
+    PointerStroke(PointerStroke&&) = default;
+    PointerStroke& operator = (const PointerStroke&) = default;
+    PointerStroke& operator = (PointerStroke&&) = default;
+
+    /// \brief Calculate a capacity that holds a time window of samples.
+    /// \param windowMicros The time window in microseconds.
+    /// \param maxSampleRateHz The highest expected sample rate.
+    /// \returns the capacity.
+    static std::size_t capacityForWindow(uint64_t windowMicros,
+                                         float maxSampleRateHz = DEFAULT_MAX_SAMPLE_RATE_HZ);
+
     /// \brief Add the given pointer event to the stroke.
     /// \returns true if the event was successfully added.
     bool add(const PointerEventArgs& e);
@@ -1364,23 +3803,99 @@ public:
     /// \returns the maximum timestamp in microseconds.
     uint64_t maxTimestampMicros() const;
 
+    /// \returns the bounds of all sample positions, including predicted samples.
+    ofRectangle axisAlignedBounds() const;
+
     /// \returns true if the last event is a pointerup or pointercancel event.
     bool isFinished() const;
 
     /// \returns true if the last event is a pointercancel.
     bool isCancelled() const;
 
-    /// \returns true if any events are still expecting updates.
+    /// \brief Determine if any committed samples are still expecting updates.
+    ///
+    /// A sample is expecting updates while its
+    /// estimatedPropertyFlagsExpectingUpdates are not all cleared by
+    /// POINTER_UPDATE events. This takes constant time.
+    ///
+    /// \returns true if any samples are still expecting updates.
     bool isExpectingUpdates() const;
 
-    /// \returns the number of events.
+    /// \returns the number of committed samples still expecting updates.
+    std::size_t numSamplesExpectingUpdates() const;
+
+    /// \returns the number of samples, including predicted samples.
     std::size_t size() const;
 
     /// \returns true if size() == 0.
     bool empty() const;
 
+    /// \returns the number of committed samples at the front of samples().
+    std::size_t committedSize() const;
+
+    /// \returns the number of predicted samples at the back of samples().
+    std::size_t predictedSize() const;
+
+    /// \returns true if the stroke has a sample capacity.
+    bool isBounded() const;
+
+    /// \returns the sample capacity, or 0 if the stroke is unbounded.
+    std::size_t capacity() const;
+
+    /// \returns the time window in microseconds, or 0 if there is none.
+    uint64_t windowMicros() const;
+
+    /// \returns the number of committed samples dropped from the front.
+    uint64_t numDroppedSamples() const;
+
+    /// \brief Simplify committed samples as they are added.
+    ///
+    /// Committed samples already in the stroke are simplified immediately.
+    /// When a bounded stroke drops samples, the simplified samples older than
+    /// its oldest sample are dropped too, so memory use stays flat.
+    ///
+    /// \param settings The simplifier settings.
+    void attachSimplifier(const PointerStrokeSimplifier::Settings& settings = PointerStrokeSimplifier::Settings());
+
+    /// \brief Stop simplifying and discard the simplified samples.
+    void detachSimplifier();
+
+    /// \returns true if a simplifier is attached.
+    bool hasSimplifier() const;
+
+    /// \returns the simplifier. Its samples are empty if none is attached.
+    const PointerStrokeSimplifier& simplifier() const;
+
+    /// \brief Resample the samples by arc length as they are added or updated.
+    ///
+    /// The resampled samples include predicted samples.
+    ///
+    /// \param settings The resampler settings.
+    void attachResampler(const PointerStrokeResampler::Settings& settings = PointerStrokeResampler::Settings());
+
+    /// \brief Stop resampling and discard the resampled samples.
+    void detachResampler();
+
+    /// \returns true if a resampler is attached.
+    bool hasResampler() const;
+
+    /// \returns the resampler. Its samples are empty if none is attached.
+    const PointerStrokeResampler& resampler() const;
+
+    /// \returns the arc length of the committed samples in pixels.
+    float length() const;
+
+    /// \returns the committed samples followed by the predicted samples.
+    const PointerSampleColumns& samples() const;
+
+    /// \brief Get the samples as events.
+    ///
+    /// The events are created on demand and only have the properties carried
+    /// by PointerSample.
+    ///
+    /// \deprecated Use samples() instead.
     /// \returns the events.
-    const std::vector<PointerEventArgs>& events() const;
+    std::vector<PointerEventArgs> events() const;
 
 private:
     /// \brief The pointer id of all events in this stroke.
@@ -1392,8 +3907,43 @@ private:
     /// \brief The maximum update sequence index.
     uint64_t _maxSequenceIndex = std::numeric_limits<uint64_t>::lowest();
 
-    /// \brief All events associated with this stroke.
-    std::vector<PointerEventArgs> _events;
+    /// \brief Samples of all events associated with this stroke.
+    PointerSampleColumns _samples;
+
+    /// \brief The number of committed samples at the front of _samples.
+    std::size_t _committedSize = 0;
+
+    /// \brief Drop committed samples from the front.
+    /// \param count The number of samples to drop. Must be <= _committedSize.
+    void _dropFront(std::size_t count);
+
+    /// \brief The stroke positions of committed samples expecting updates by
+    /// sequence index.
+    ///
+    /// A stroke position counts dropped samples, so it is the index in
+    /// _samples plus _numDroppedSamples.
+    PointerSequenceIndexMap _samplesExpectingUpdates;
+
+    /// \brief The sample capacity, or 0 if unbounded.
+    std::size_t _capacity = 0;
+
+    /// \brief The time window in microseconds, or 0 if there is none.
+    uint64_t _windowMicros = 0;
+
+    /// \brief The number of committed samples dropped from the front.
+    uint64_t _numDroppedSamples = 0;
+
+    /// \brief True if committed samples are passed to _simplifier.
+    bool _hasSimplifier = false;
+
+    /// \brief The simplifier of committed samples.
+    PointerStrokeSimplifier _simplifier;
+
+    /// \brief True if samples are passed to _resampler.
+    bool _hasResampler = false;
+
+    /// \brief The resampler of all samples.
+    PointerStrokeResampler _resampler;
 
 };
 
@@ -1432,14 +3982,21 @@ public:
     void clear();
 
     /// \returns the Settings.
-    Settings settings() const;
+    const Settings& settings() const;
 
     /// \brief A callback for all Pointer Events.
     /// \param e The Pointer Event arguments.
     void add(const PointerEventArgs& e);
 
-    // \returns the stroke map.
-    const std::map<std::size_t, std::vector<PointerStroke>>& strokes() const;
+    /// \param pointerId The pointer id.
+    /// \returns the strokes of the pointer, oldest first.
+    const std::vector<PointerStroke>& strokesForPointerId(std::size_t pointerId) const;
+
+    /// \brief Get all strokes by pointer id.
+    ///
+    /// \deprecated Use strokesForPointerId() instead. This copies all strokes.
+    /// \returns the strokes of all pointers that have strokes.
+    std::map<std::size_t, std::vector<PointerStroke>> strokes() const;
 
     struct Settings
     {
@@ -1460,14 +4017,28 @@ public:
         /// \brief The color of predicted points.
         ofColor predictedPointColor;
 
+        /// \brief The maximum number of samples kept per stroke.
+        ///
+        /// If non-zero, strokes are bounded to this many samples and to a
+        /// time window of timeoutMillis. If 0, strokes are unbounded.
+        std::size_t maxStrokeSamples = 0;
+
     };
 
 private:
     /// \brief The Settings.
     Settings _settings;
 
-    /// \brief A map of strokes.
-    std::map<std::size_t, std::vector<PointerStroke>> _strokes;
+    /// \param pointerId The pointer id.
+    /// \returns the strokes of the pointer, created if needed.
+    std::vector<PointerStroke>& _strokesForPointerId(std::size_t pointerId);
+
+    /// \brief The strokes of each small pointer id.
+    std::vector<PointerStroke> _strokes[PointerEvents::MAX_ACTIVE_POINTERS];
+
+    /// \brief The strokes of pointers that did not fit in the active pointer
+    /// table and kept their source pointer id.
+    std::map<std::size_t, std::vector<PointerStroke>> _overflowStrokes;
 
 };
 
@@ -1526,11 +4097,23 @@ public:
     const PointerEventArgs* lastEventForPointerId(std::size_t pointerId) const;
 
 private:
+    /// \param pointerId The pointer id.
+    /// \returns the indices in _events of the pointer's events, or nullptr if
+    /// it has none.
+    const std::vector<std::size_t>* _findEventIndices(std::size_t pointerId) const;
+
     /// \brief The set of pointer events in order of addition.
     std::vector<PointerEventArgs> _events;
 
-    /// \brief A mapping between the pointer event keys and the pointer events.
-    std::map<std::size_t, std::vector<PointerEventArgs*>> _eventsForPointerId;
+    /// \brief The indices in _events of the events of each small pointer id.
+    std::vector<std::size_t> _eventIndices[PointerEvents::MAX_ACTIVE_POINTERS];
+
+    /// \brief The indices in _events of the events of pointers that did not
+    /// fit in the active pointer table and kept their source pointer id.
+    std::map<std::size_t, std::vector<std::size_t>> _overflowEventIndices;
+
+    /// \brief The number of pointers with events.
+    std::size_t _numPointers = 0;
 
 };
 
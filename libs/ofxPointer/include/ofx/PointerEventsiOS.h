@@ -35,19 +35,8 @@
     ofxiOSGLKView* _viewGLK;
     ofxiOSEAGLView* _viewEAGL;
 
-    /// \brief The start time of the program to calculate set timestamps based on elapsed time.
-    NSTimeInterval _startTimeSeconds;
-
-    /// \brief Keep track of active pointers based on UITouchType.
-    std::map<UITouchType, std::set<int64_t>> _activePointerIndices;
-
-    /// \brief Keep track of the primary pointer for each UITouchType.
-    std::map<UITouchType, int64_t> _primaryPointerIndices;
-
 }
 
-- (void)resetTouches;
-
 /// \brief Convert UITouch data to PointerEventArgs values.
 - (ofx::PointerEventArgs)toPointerEventArgs:(UIView*) view
                                   withTouch:(UITouch*) touch
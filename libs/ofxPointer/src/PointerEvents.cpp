@@ -6,20 +6,167 @@
 
 
 #include "ofx/PointerEvents.h"
+#include <algorithm>
 #include <cassert>
+#include <limits>
+#include <mutex>
 #include "ofGraphics.h"
 #include "ofMesh.h"
 
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OFX_POINTER_SIMD_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define OFX_POINTER_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+
 namespace ofx {
 
 
+namespace {
+
+
+#if defined(OFX_POINTER_SIMD_SSE2) || defined(OFX_POINTER_SIMD_NEON)
+
+
+// Minimal four lane float vector wrappers used by the batch kernels.
+#if defined(OFX_POINTER_SIMD_SSE2)
+
+typedef __m128 Float4;
+
+inline Float4 load4(const float* p) { return _mm_loadu_ps(p); }
+inline void store4(float* p, Float4 v) { _mm_storeu_ps(p, v); }
+inline Float4 set4(float x) { return _mm_set1_ps(x); }
+inline Float4 add4(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+inline Float4 sub4(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+inline Float4 mul4(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+inline Float4 div4(Float4 a, Float4 b) { return _mm_div_ps(a, b); }
+inline Float4 sqrt4(Float4 a) { return _mm_sqrt_ps(a); }
+inline Float4 and4(Float4 a, Float4 b) { return _mm_and_ps(a, b); }
+inline Float4 or4(Float4 a, Float4 b) { return _mm_or_ps(a, b); }
+inline Float4 xor4(Float4 a, Float4 b) { return _mm_xor_ps(a, b); }
+inline Float4 gt4(Float4 a, Float4 b) { return _mm_cmpgt_ps(a, b); }
+inline Float4 ge4(Float4 a, Float4 b) { return _mm_cmpge_ps(a, b); }
+inline Float4 lt4(Float4 a, Float4 b) { return _mm_cmplt_ps(a, b); }
+inline Float4 le4(Float4 a, Float4 b) { return _mm_cmple_ps(a, b); }
+inline Float4 eq4(Float4 a, Float4 b) { return _mm_cmpeq_ps(a, b); }
+inline Float4 min4(Float4 a, Float4 b) { return _mm_min_ps(a, b); }
+inline Float4 max4(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+inline Float4 select4(Float4 mask, Float4 a, Float4 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+inline bool all4(Float4 mask) { return _mm_movemask_ps(mask) == 0xF; }
+
+#else
+
+typedef float32x4_t Float4;
+
+inline Float4 load4(const float* p) { return vld1q_f32(p); }
+inline void store4(float* p, Float4 v) { vst1q_f32(p, v); }
+inline Float4 set4(float x) { return vdupq_n_f32(x); }
+inline Float4 add4(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+inline Float4 sub4(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+inline Float4 mul4(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+inline Float4 div4(Float4 a, Float4 b) { return vdivq_f32(a, b); }
+inline Float4 sqrt4(Float4 a) { return vsqrtq_f32(a); }
+inline Float4 and4(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+inline Float4 or4(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+inline Float4 xor4(Float4 a, Float4 b) { return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+inline Float4 gt4(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+inline Float4 ge4(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcgeq_f32(a, b)); }
+inline Float4 lt4(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+inline Float4 le4(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcleq_f32(a, b)); }
+inline Float4 eq4(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vceqq_f32(a, b)); }
+inline Float4 min4(Float4 a, Float4 b) { return vminq_f32(a, b); }
+inline Float4 max4(Float4 a, Float4 b) { return vmaxq_f32(a, b); }
+inline Float4 select4(Float4 mask, Float4 a, Float4 b) { return vbslq_f32(vreinterpretq_u32_f32(mask), a, b); }
+inline bool all4(Float4 mask) { return vminvq_u32(vreinterpretq_u32_f32(mask)) != 0; }
+
+#endif
+
+
+inline Float4 abs4(Float4 a)
+{
+    return xor4(a, and4(a, set4(-0.0f)));
+}
+
+
+/// \brief Copy the sign of s onto the non-negative value a.
+inline Float4 withSignOf4(Float4 a, Float4 s)
+{
+    return xor4(a, and4(s, set4(-0.0f)));
+}
+
+
+inline Float4 round4(Float4 a)
+{
+    // Valid for |a| < 2^22.
+    const Float4 magic = set4(12582912.0f);
+    return sub4(add4(a, magic), magic);
+}
+
+
+inline Float4 floor4(Float4 a)
+{
+    Float4 r = round4(a);
+    return sub4(r, and4(gt4(r, a), set4(1)));
+}
+
+
+#endif
+
+
+/// \brief Find the minimum and maximum of a non-empty array.
+void toMinMax(const float* values, std::size_t size, float& minValue, float& maxValue)
+{
+    std::size_t i = 0;
+    minValue = values[0];
+    maxValue = values[0];
+
+#if defined(OFX_POINTER_SIMD_SSE2) || defined(OFX_POINTER_SIMD_NEON)
+    if (size >= 4)
+    {
+        Float4 minValues = load4(values);
+        Float4 maxValues = minValues;
+
+        for (i = 4; i + 4 <= size; i += 4)
+        {
+            Float4 v = load4(values + i);
+            minValues = min4(minValues, v);
+            maxValues = max4(maxValues, v);
+        }
+
+        float mins[4];
+        float maxs[4];
+        store4(mins, minValues);
+        store4(maxs, maxValues);
+
+        for (std::size_t j = 0; j < 4; ++j)
+        {
+            minValue = std::min(minValue, mins[j]);
+            maxValue = std::max(maxValue, maxs[j]);
+        }
+    }
+#endif
+
+    for (; i < size; ++i)
+    {
+        minValue = std::min(minValue, values[i]);
+        maxValue = std::max(maxValue, values[i]);
+    }
+}
+
+
+} // namespace
+
+
 const std::string EventArgs::EVENT_TYPE_UNKNOWN = "EVENT_TYPE_UNKNOWN";
 
 
 EventArgs::EventArgs(): EventArgs(nullptr,
                                   EVENT_TYPE_UNKNOWN,
-                                  ofGetElapsedTimeMicros(),
+                                  nowMicros(),
                                   0)
 {
 }
@@ -29,6 +176,18 @@ EventArgs::EventArgs(const void* eventSource,
                      const std::string& eventType,
                      uint64_t timestampMicros,
                      uint64_t detail):
+    EventArgs(eventSource,
+              _intern(eventType),
+              timestampMicros,
+              detail)
+{
+}
+
+
+EventArgs::EventArgs(const void* eventSource,
+                     const std::string* eventType,
+                     uint64_t timestampMicros,
+                     uint64_t detail):
     _eventSource(eventSource),
     _eventType(eventType),
     _timestampMicros(timestampMicros),
@@ -48,9 +207,9 @@ const void* EventArgs::eventSource() const
 }
 
 
-std::string EventArgs::eventType() const
+const std::string& EventArgs::eventType() const
 {
-    return _eventType;
+    return *_eventType;
 }
 
 
@@ -72,6 +231,50 @@ uint64_t EventArgs::detail() const
 }
 
 
+uint64_t EventArgs::nowMicros()
+{
+    return toTimestampMicros(std::chrono::steady_clock::now());
+}
+
+
+uint64_t EventArgs::toTimestampMicros(std::chrono::steady_clock::time_point time)
+{
+    // The epoch is the app start, as for ofGetElapsedTimeMicros(). It is
+    // fixed the first time the clock is used, so later calls to
+    // ofResetElapsedTimeCounter() do not move it.
+    static const std::chrono::steady_clock::time_point epoch =
+        std::chrono::steady_clock::now() - std::chrono::microseconds(ofGetElapsedTimeMicros());
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(time - epoch).count();
+}
+
+
+void EventArgs::_set(const void* eventSource,
+                     const std::string* eventType,
+                     uint64_t timestampMicros,
+                     uint64_t detail)
+{
+    _eventSource = eventSource;
+    _eventType = eventType;
+    _timestampMicros = timestampMicros;
+    _detail = detail;
+}
+
+
+const std::string* EventArgs::_intern(const std::string& value)
+{
+    if (value == EVENT_TYPE_UNKNOWN)
+        return &EVENT_TYPE_UNKNOWN;
+
+    // A std::set never moves its nodes, so the pointers remain valid.
+    static std::mutex mutex;
+    static std::set<std::string> strings;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    return &*strings.insert(value).first;
+}
+
+
 PointShape::PointShape()
 {
 }
@@ -95,6 +298,7 @@ PointShape::PointShape(ShapeType shapeType,
                        float widthTolerance,
                        float heightTolerance,
                        float angleDeg):
+    _shapeType(shapeType),
     _width(width),
     _height(height),
     _widthTolerance(widthTolerance),
@@ -171,32 +375,451 @@ float PointShape::axisAlignedHeight() const
 
 void PointShape::_calculateAxisAlignedSize() const
 {
-    float _angleRad = angleRad();
+    toAxisAlignedSize(_shapeType,
+                      _width,
+                      _height,
+                      _angleDeg,
+                      _axisAlignedWidth,
+                      _axisAlignedHeight);
+    _axisAlignedSizeCached = true;
+}
+
+
+void PointShape::toAxisAlignedSize(ShapeType shapeType,
+                                   float width,
+                                   float height,
+                                   float angleDeg,
+                                   float& axisAlignedWidth,
+                                   float& axisAlignedHeight)
+{
+    float _angleRad = glm::radians(angleDeg);
 
-    switch (_shapeType)
+    switch (shapeType)
     {
         case ShapeType::ELLIPSE:
         {
             // via http://www.iquilezles.org/www/articles/ellipses/ellipses.htm
-            auto u = glm::rotate(glm::vec2(1, 0) * _width  / 2.0f, _angleRad);
-            auto v = glm::rotate(glm::vec2(0, 1) * _height / 2.0f, _angleRad);
+            auto u = glm::rotate(glm::vec2(1, 0) * width  / 2.0f, _angleRad);
+            auto v = glm::rotate(glm::vec2(0, 1) * height / 2.0f, _angleRad);
             glm::vec2 size = glm::sqrt(u * u + v * v) * 2;
-            _axisAlignedWidth = size.x;
-            _axisAlignedHeight = size.y;
+            axisAlignedWidth = size.x;
+            axisAlignedHeight = size.y;
             break;
         }
         case ShapeType::RECTANGLE:
         {
             // via https://stackoverflow.com/a/6657768/1518329
-            float _cos = std::cos(_angleRad);
-            float _sin = std::sin(_angleRad);
-            _axisAlignedWidth  = _height * _sin + _width * _cos;
-            _axisAlignedHeight = _height * _cos + _width * _sin;
+            float _cos = std::abs(std::cos(_angleRad));
+            float _sin = std::abs(std::sin(_angleRad));
+            axisAlignedWidth  = height * _sin + width * _cos;
+            axisAlignedHeight = height * _cos + width * _sin;
             break;
         }
     }
+}
 
-    _axisAlignedSizeCached = true;
+
+namespace {
+
+
+#if defined(OFX_POINTER_SIMD_SSE2) || defined(OFX_POINTER_SIMD_NEON)
+
+
+/// \brief Calculate sin and cos of angles in degrees.
+///
+/// The angle is reduced to [-45, 45] degrees in degrees, so the result is
+/// valid for |angleDeg| < 2^22 * 90. The polynomials are from the Cephes
+/// sinf and cosf implementations.
+inline void sinCosDeg4(Float4 angleDeg, Float4& s, Float4& c)
+{
+    Float4 k = round4(mul4(angleDeg, set4(1.0f / 90.0f)));
+    Float4 r = mul4(sub4(angleDeg, mul4(k, set4(90))), set4(0.01745329251994329576923690768489f));
+    Float4 z = mul4(r, r);
+
+    Float4 ps = set4(-1.9515295891e-4f);
+    ps = add4(mul4(ps, z), set4(8.3321608736e-3f));
+    ps = add4(mul4(ps, z), set4(-1.6666654611e-1f));
+    Float4 sinR = add4(mul4(mul4(ps, z), r), r);
+
+    Float4 pc = set4(2.443315711809948e-5f);
+    pc = add4(mul4(pc, z), set4(-1.388731625493765e-3f));
+    pc = add4(mul4(pc, z), set4(4.166664568298827e-2f));
+    Float4 cosR = add4(sub4(set4(1), mul4(set4(0.5f), z)), mul4(mul4(pc, z), z));
+
+    // The quadrant, 0 - 3.
+    Float4 q = sub4(k, mul4(floor4(mul4(k, set4(0.25f))), set4(4)));
+
+    Float4 swap = or4(eq4(q, set4(1)), eq4(q, set4(3)));
+    Float4 negateSin = ge4(q, set4(2));
+    Float4 negateCos = or4(eq4(q, set4(1)), eq4(q, set4(2)));
+    Float4 signBit = set4(-0.0f);
+
+    s = xor4(select4(swap, cosR, sinR), and4(negateSin, signBit));
+    c = xor4(select4(swap, sinR, cosR), and4(negateCos, signBit));
+}
+
+
+/// \brief Calculate axis-aligned sizes of four shapes.
+/// \param isRectangle A lane mask selecting the RECTANGLE calculation.
+/// \returns false, without writing any results, if any angle is outside of
+///          the domain handled by the vector path.
+bool toAxisAlignedSize4(Float4 isRectangle,
+                        Float4 width,
+                        Float4 height,
+                        Float4 angleDeg,
+                        Float4& axisAlignedWidth,
+                        Float4& axisAlignedHeight)
+{
+    if (!all4(le4(abs4(angleDeg), set4(1e6f))))
+        return false;
+
+    Float4 s;
+    Float4 c;
+    sinCosDeg4(angleDeg, s, c);
+
+    Float4 wc = mul4(width, c);
+    Float4 ws = mul4(width, s);
+    Float4 hc = mul4(height, c);
+    Float4 hs = mul4(height, s);
+
+    Float4 ellipseWidth = sqrt4(add4(mul4(wc, wc), mul4(hs, hs)));
+    Float4 ellipseHeight = sqrt4(add4(mul4(ws, ws), mul4(hc, hc)));
+
+    // Rectangle extents use |sin| and |cos|, so they hold in every quadrant.
+    Float4 rectangleWidth = add4(mul4(height, abs4(s)), mul4(width, abs4(c)));
+    Float4 rectangleHeight = add4(mul4(height, abs4(c)), mul4(width, abs4(s)));
+
+    axisAlignedWidth = select4(isRectangle, rectangleWidth, ellipseWidth);
+    axisAlignedHeight = select4(isRectangle, rectangleHeight, ellipseHeight);
+    return true;
+}
+
+
+#endif
+
+
+} // namespace
+
+
+void PointShape::toAxisAlignedSize(ShapeType shapeType,
+                                   const float* widths,
+                                   const float* heights,
+                                   const float* anglesDeg,
+                                   float* axisAlignedWidths,
+                                   float* axisAlignedHeights,
+                                   std::size_t size)
+{
+    std::size_t i = 0;
+
+#if defined(OFX_POINTER_SIMD_SSE2) || defined(OFX_POINTER_SIMD_NEON)
+    Float4 isRectangle = set4(0);
+    if (shapeType == ShapeType::RECTANGLE)
+        isRectangle = eq4(isRectangle, isRectangle);
+
+    for (; i + 4 <= size; i += 4)
+    {
+        Float4 w;
+        Float4 h;
+
+        if (toAxisAlignedSize4(isRectangle, load4(widths + i), load4(heights + i), load4(anglesDeg + i), w, h))
+        {
+            store4(axisAlignedWidths + i, w);
+            store4(axisAlignedHeights + i, h);
+        }
+        else
+        {
+            for (std::size_t j = i; j < i + 4; ++j)
+                toAxisAlignedSize(shapeType, widths[j], heights[j], anglesDeg[j], axisAlignedWidths[j], axisAlignedHeights[j]);
+        }
+    }
+#endif
+
+    for (; i < size; ++i)
+        toAxisAlignedSize(shapeType, widths[i], heights[i], anglesDeg[i], axisAlignedWidths[i], axisAlignedHeights[i]);
+}
+
+
+namespace {
+
+
+/// \brief The smallest semi-axis used for intersection tests, so that
+/// zero-sized shapes behave like points.
+const float MIN_SEMI_AXIS = 1e-4f;
+
+
+/// \brief An oriented box.
+struct OrientedBox
+{
+    glm::vec2 center;
+    glm::vec2 axisX;
+    glm::vec2 axisY;
+    float halfWidth;
+    float halfHeight;
+};
+
+
+OrientedBox toOrientedBox(const glm::vec2& center, float width, float height, float angleDeg)
+{
+    float angleRad = glm::radians(angleDeg);
+    float c = std::cos(angleRad);
+    float s = std::sin(angleRad);
+
+    OrientedBox box;
+    box.center = center;
+    box.axisX = glm::vec2(c, s);
+    box.axisY = glm::vec2(-s, c);
+    box.halfWidth = std::abs(width) / 2;
+    box.halfHeight = std::abs(height) / 2;
+    return box;
+}
+
+
+/// \returns the projected radius of a box on an axis.
+float projectedRadius(const OrientedBox& box, const glm::vec2& axis)
+{
+    return box.halfWidth * std::abs(glm::dot(box.axisX, axis))
+         + box.halfHeight * std::abs(glm::dot(box.axisY, axis));
+}
+
+
+/// \brief Test two oriented boxes with the separating axis theorem.
+bool boxIntersectsBox(const OrientedBox& a, const OrientedBox& b)
+{
+    glm::vec2 d = b.center - a.center;
+    const glm::vec2 axes[] = { a.axisX, a.axisY, b.axisX, b.axisY };
+
+    for (const auto& axis: axes)
+    {
+        if (std::abs(glm::dot(d, axis)) > projectedRadius(a, axis) + projectedRadius(b, axis))
+            return false;
+    }
+
+    return true;
+}
+
+
+/// \brief Test an oriented box and a circle.
+bool boxIntersectsCircle(const OrientedBox& box, const glm::vec2& center, float radius)
+{
+    glm::vec2 d = center - box.center;
+    glm::vec2 local(glm::dot(d, box.axisX), glm::dot(d, box.axisY));
+    glm::vec2 closest(ofClamp(local.x, -box.halfWidth, box.halfWidth),
+                      ofClamp(local.y, -box.halfHeight, box.halfHeight));
+    glm::vec2 offset = local - closest;
+    return glm::dot(offset, offset) <= radius * radius;
+}
+
+
+/// \brief Test an ellipse and an oriented box.
+///
+/// The box is mapped into the frame where the ellipse is the unit circle,
+/// which turns it into a parallelogram and keeps the intersection exact.
+bool ellipseIntersectsBox(const OrientedBox& ellipse, const OrientedBox& box)
+{
+    float a = std::max(ellipse.halfWidth, MIN_SEMI_AXIS);
+    float b = std::max(ellipse.halfHeight, MIN_SEMI_AXIS);
+
+    glm::vec2 d = box.center - ellipse.center;
+    glm::vec2 ex = box.axisX * box.halfWidth;
+    glm::vec2 ey = box.axisY * box.halfHeight;
+
+    auto toUnit = [&](const glm::vec2& v) {
+        return glm::vec2(glm::dot(v, ellipse.axisX) / a, glm::dot(v, ellipse.axisY) / b);
+    };
+
+    const glm::vec2 corners[] = {
+        toUnit(d - ex - ey),
+        toUnit(d + ex - ey),
+        toUnit(d + ex + ey),
+        toUnit(d - ex + ey)
+    };
+
+    bool hasPositive = false;
+    bool hasNegative = false;
+
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        const glm::vec2& p0 = corners[i];
+        const glm::vec2& p1 = corners[(i + 1) % 4];
+        glm::vec2 edge = p1 - p0;
+
+        // Which side of the edge the origin is on.
+        float cross = edge.x * -p0.y - edge.y * -p0.x;
+        hasPositive = hasPositive || cross > 0;
+        hasNegative = hasNegative || cross < 0;
+
+        // The distance from the origin to the edge.
+        float lengthSquared = glm::dot(edge, edge);
+        float t = lengthSquared > 0 ? ofClamp(-glm::dot(p0, edge) / lengthSquared, 0, 1) : 0;
+        glm::vec2 closest = p0 + edge * t;
+
+        if (glm::dot(closest, closest) <= 1)
+            return true;
+    }
+
+    // The origin is inside the parallelogram if it is on the same side of
+    // all edges. A degenerate box has no area and no side, so it was fully
+    // tested by the edge distances above.
+    return hasPositive != hasNegative;
+}
+
+
+/// \brief Test an ellipse and a circle.
+///
+/// This finds the closest point on the ellipse with the trig-free iteration
+/// described at https://github.com/0xfaded/ellipse_demo.
+bool ellipseIntersectsCircle(const OrientedBox& ellipse, const glm::vec2& center, float radius)
+{
+    float a = std::max(ellipse.halfWidth, MIN_SEMI_AXIS);
+    float b = std::max(ellipse.halfHeight, MIN_SEMI_AXIS);
+
+    glm::vec2 d = center - ellipse.center;
+    float px = std::abs(glm::dot(d, ellipse.axisX));
+    float py = std::abs(glm::dot(d, ellipse.axisY));
+
+    if ((px * px) / (a * a) + (py * py) / (b * b) <= 1)
+        return true;
+
+    float tx = 0.70710678118f;
+    float ty = 0.70710678118f;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        float x = a * tx;
+        float y = b * ty;
+
+        float ex = (a * a - b * b) * tx * tx * tx / a;
+        float ey = (b * b - a * a) * ty * ty * ty / b;
+
+        float rx = x - ex;
+        float ry = y - ey;
+
+        float qx = px - ex;
+        float qy = py - ey;
+
+        float r = std::hypot(rx, ry);
+        float q = std::hypot(qx, qy);
+
+        tx = ofClamp((qx * r / q + ex) / a, 0, 1);
+        ty = ofClamp((qy * r / q + ey) / b, 0, 1);
+
+        float t = std::hypot(tx, ty);
+        tx /= t;
+        ty /= t;
+    }
+
+    float dx = px - a * tx;
+    float dy = py - b * ty;
+    return dx * dx + dy * dy <= radius * radius;
+}
+
+
+/// \returns true if two axis-aligned boxes given by center and half extents
+/// overlap.
+inline bool overlaps(float ax, float ay, float ahw, float ahh,
+                     float bx, float by, float bhw, float bhh)
+{
+    return std::abs(ax - bx) <= ahw + bhw && std::abs(ay - by) <= ahh + bhh;
+}
+
+
+} // namespace
+
+
+bool PointShape::intersectsRectangle(const glm::vec2& position,
+                                     const ofRectangle& rectangle,
+                                     float rectangleAngleDeg) const
+{
+    bool result = false;
+    intersectsRectangles(position, &rectangle, &rectangleAngleDeg, 1, &result);
+    return result;
+}
+
+
+bool PointShape::intersectsCircle(const glm::vec2& position,
+                                  const glm::vec2& center,
+                                  float radius) const
+{
+    bool result = false;
+    intersectsCircles(position, &center, &radius, 1, &result);
+    return result;
+}
+
+
+void PointShape::intersectsRectangles(const glm::vec2& position,
+                                      const ofRectangle* rectangles,
+                                      const float* anglesDeg,
+                                      std::size_t size,
+                                      bool* results) const
+{
+    OrientedBox shape = toOrientedBox(position, _width, _height, _angleDeg);
+    float shapeHalfWidth = axisAlignedWidth() / 2;
+    float shapeHalfHeight = axisAlignedHeight() / 2;
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        const ofRectangle& rectangle = rectangles[i];
+        float angleDeg = anglesDeg ? anglesDeg[i] : 0;
+        glm::vec2 center(rectangle.x + rectangle.width / 2,
+                         rectangle.y + rectangle.height / 2);
+
+        float rectangleWidth = std::abs(rectangle.width);
+        float rectangleHeight = std::abs(rectangle.height);
+
+        if (angleDeg != 0)
+        {
+            toAxisAlignedSize(ShapeType::RECTANGLE,
+                              rectangleWidth,
+                              rectangleHeight,
+                              angleDeg,
+                              rectangleWidth,
+                              rectangleHeight);
+        }
+
+        // Most targets are rejected by their bounds.
+        if (!overlaps(position.x, position.y, shapeHalfWidth, shapeHalfHeight,
+                      center.x, center.y, rectangleWidth / 2, rectangleHeight / 2))
+        {
+            results[i] = false;
+            continue;
+        }
+
+        OrientedBox box = toOrientedBox(center, rectangle.width, rectangle.height, angleDeg);
+
+        if (_shapeType == ShapeType::RECTANGLE)
+            results[i] = boxIntersectsBox(shape, box);
+        else
+            results[i] = ellipseIntersectsBox(shape, box);
+    }
+}
+
+
+void PointShape::intersectsCircles(const glm::vec2& position,
+                                   const glm::vec2* centers,
+                                   const float* radii,
+                                   std::size_t size,
+                                   bool* results) const
+{
+    OrientedBox shape = toOrientedBox(position, _width, _height, _angleDeg);
+    float shapeHalfWidth = axisAlignedWidth() / 2;
+    float shapeHalfHeight = axisAlignedHeight() / 2;
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        float radius = std::abs(radii[i]);
+
+        if (!overlaps(position.x, position.y, shapeHalfWidth, shapeHalfHeight,
+                      centers[i].x, centers[i].y, radius, radius))
+        {
+            results[i] = false;
+            continue;
+        }
+
+        if (_shapeType == ShapeType::RECTANGLE)
+            results[i] = boxIntersectsCircle(shape, centers[i], radius);
+        else
+            results[i] = ellipseIntersectsCircle(shape, centers[i], radius);
+    }
 }
 
 
@@ -211,7 +834,7 @@ Point::Point(const glm::vec2& position): Point(position, PointShape())
 
 
 Point::Point(const glm::vec2& position, const PointShape& shape):
-    Point(position, PointShape(), 0)
+    Point(position, shape, 0)
 {
 }
 
@@ -255,13 +878,13 @@ Point::~Point()
 }
 
 
-glm::vec2 Point::position() const
+const glm::vec2& Point::position() const
 {
     return _position;
 }
 
 
-glm::vec2 Point::precisePosition() const
+const glm::vec2& Point::precisePosition() const
 {
     return _precisePosition;
 }
@@ -344,18 +967,31 @@ float Point::altitudeRad() const
 
 
 void Point::_cacheAzimuthAltitude() const
+{
+    toAzimuthAltitudeDeg(_tiltXDeg, _tiltYDeg, _azimuthDeg, _altitudeDeg);
+    _azimuthAltitudeCached = true;
+}
+
+
+void Point::toAzimuthAltitudeDeg(float tiltXDeg,
+                                 float tiltYDeg,
+                                 float& azimuthDeg,
+                                 float& altitudeDeg)
 {
     double _azimuthRad = 0;
     double _altitudeRad = 0;
 
-    bool tiltXIsZero = ofIsFloatEqual(_tiltXDeg, 0.0f);
-    bool tiltYIsZero = ofIsFloatEqual(_tiltYDeg, 0.0f);
+    bool tiltXIsZero = ofIsFloatEqual(tiltXDeg, 0.0f);
+    bool tiltYIsZero = ofIsFloatEqual(tiltYDeg, 0.0f);
+
+    float tiltXRad = glm::radians(tiltXDeg);
+    float tiltYRad = glm::radians(tiltYDeg);
 
     // Take care of edge cases where std::tan(...) is undefined.
     if (!tiltXIsZero && !tiltYIsZero)
     {
-        double _tanTy = std::tan(tiltYRad());
-        _azimuthRad = std::atan2(_tanTy, std::tan(tiltXRad()));
+        double _tanTy = std::tan(tiltYRad);
+        _azimuthRad = std::atan2(_tanTy, std::tan(tiltXRad));
         _altitudeRad = std::atan(std::sin(_azimuthRad) / _tanTy);
     }
     else if (tiltXIsZero && tiltYIsZero)
@@ -365,46 +1001,342 @@ void Point::_cacheAzimuthAltitude() const
     }
     else if (tiltXIsZero)
     {
-        _azimuthRad = tiltYRad() > 0 ? glm::half_pi<double>() : glm::three_over_two_pi<double>();
-        _altitudeRad = tiltYRad();
+        _azimuthRad = tiltYRad > 0 ? glm::half_pi<double>() : glm::three_over_two_pi<double>();
+        _altitudeRad = tiltYRad;
     }
     else if (tiltYIsZero)
     {
-        _azimuthRad = tiltXRad() > 0 ? 0 : glm::pi<double>();
-        _altitudeRad = tiltXRad();
+        _azimuthRad = tiltXRad > 0 ? 0 : glm::pi<double>();
+        _altitudeRad = tiltXRad;
     }
 
     // Put into range 0 - 2PI.
     if (_azimuthRad < 0)
         _azimuthRad += glm::two_pi<double>();
 
-    _azimuthDeg = glm::degrees(_azimuthRad);
-    _altitudeDeg = glm::degrees(_altitudeRad);
+    azimuthDeg = glm::degrees(_azimuthRad);
+    altitudeDeg = glm::degrees(_altitudeRad);
+}
+
 
-    _azimuthAltitudeCached = true;
+namespace {
+
+
+#if defined(OFX_POINTER_SIMD_SSE2) || defined(OFX_POINTER_SIMD_NEON)
+
+
+/// \brief Calculate tan(x) for |x| <= pi / 2.
+///
+/// The polynomial is from the Cephes tanf implementation. Values above pi / 4
+/// use tan(x) = 1 / tan(pi / 2 - x), with a two part pi / 2 so that x == pi / 2
+/// in float behaves like std::tan.
+inline Float4 tan4(Float4 x)
+{
+    Float4 ax = abs4(x);
+    Float4 big = gt4(ax, set4(0.78539816339744830962f));
+    Float4 r = select4(big, add4(sub4(set4(1.57079637050628662109375f), ax), set4(-4.37113900018624283e-8f)), ax);
+    Float4 z = mul4(r, r);
+    Float4 p = set4(9.38540185543e-3f);
+    p = add4(mul4(p, z), set4(3.11992232697e-3f));
+    p = add4(mul4(p, z), set4(2.44301354525e-2f));
+    p = add4(mul4(p, z), set4(5.34112807005e-2f));
+    p = add4(mul4(p, z), set4(1.33387994085e-1f));
+    p = add4(mul4(p, z), set4(3.33331568548e-1f));
+    Float4 t = add4(mul4(mul4(p, z), r), r);
+    t = select4(big, div4(set4(1), t), t);
+    return withSignOf4(t, x);
 }
 
-const PointShape& Point::shape() const
+
+/// \brief Calculate atan(x).
+///
+/// The range reduction and polynomial are from the Cephes atanf
+/// implementation.
+inline Float4 atan4(Float4 x)
 {
-    return _shape;
+    Float4 ax = abs4(x);
+    Float4 big = gt4(ax, set4(2.414213562373095f));
+    Float4 mid = gt4(ax, set4(0.4142135623730950f));
+    Float4 y0 = select4(big, set4(1.57079632679489661923f), select4(mid, set4(0.78539816339744830962f), set4(0)));
+    Float4 r = select4(big,
+                       div4(set4(-1), ax),
+                       select4(mid, div4(sub4(ax, set4(1)), add4(ax, set4(1))), ax));
+    Float4 z = mul4(r, r);
+    Float4 p = set4(8.05374449538e-2f);
+    p = sub4(mul4(p, z), set4(1.38776856032e-1f));
+    p = add4(mul4(p, z), set4(1.99777106478e-1f));
+    p = sub4(mul4(p, z), set4(3.33329491539e-1f));
+    Float4 a = add4(add4(mul4(mul4(p, z), r), r), y0);
+    return withSignOf4(a, x);
 }
 
 
-const std::string PointerEventArgs::TYPE_MOUSE    = "mouse";
-const std::string PointerEventArgs::TYPE_PEN      = "pen";
-const std::string PointerEventArgs::TYPE_TOUCH    = "touch";
-const std::string PointerEventArgs::TYPE_UNKNOWN  = "unknown";
+/// \brief Determine which tilt lanes the vector path handles.
+///
+/// NaN and out of range tilts are left to the scalar path, as are tiny
+/// non-zero tilts, where the scalar results are dominated by rounding.
+inline Float4 inTiltDomain4(Float4 tiltDeg)
+{
+    Float4 a = abs4(tiltDeg);
+    return and4(le4(a, set4(90)), or4(eq4(a, set4(0)), ge4(a, set4(1e-3f))));
+}
 
-const std::string PointerEventArgs::POINTER_OVER   = "pointerover";
-const std::string PointerEventArgs::POINTER_ENTER  = "pointerenter";
-const std::string PointerEventArgs::POINTER_DOWN   = "pointerdown";
-const std::string PointerEventArgs::POINTER_MOVE   = "pointermove";
-const std::string PointerEventArgs::POINTER_UP     = "pointerup";
-const std::string PointerEventArgs::POINTER_CANCEL = "pointercancel";
-const std::string PointerEventArgs::POINTER_UPDATE = "pointerupdate";
-const std::string PointerEventArgs::POINTER_OUT    = "pointerout";
-const std::string PointerEventArgs::POINTER_LEAVE  = "pointerleave";
-const std::string PointerEventArgs::POINTER_SCROLL = "pointerscroll";
+
+/// \brief Calculate azimuth and altitude for four tilt pairs.
+/// \returns false, without writing any results, if any of the lanes is
+///          outside of the domain handled by the vector path.
+bool toAzimuthAltitudeDeg4(const float* tiltXDeg,
+                           const float* tiltYDeg,
+                           float* azimuthDeg,
+                           float* altitudeDeg)
+{
+    const Float4 zero = set4(0);
+    const Float4 degToRad = set4(0.01745329251994329576923690768489f);
+    const Float4 radToDeg = set4(57.295779513082320876798154814105f);
+
+    Float4 tx = load4(tiltXDeg);
+    Float4 ty = load4(tiltYDeg);
+
+    if (!all4(and4(inTiltDomain4(tx), inTiltDomain4(ty))))
+        return false;
+
+    Float4 txIsZero = eq4(tx, zero);
+    Float4 tyIsZero = eq4(ty, zero);
+
+    Float4 tanTx = tan4(mul4(tx, degToRad));
+    Float4 tanTy = tan4(mul4(ty, degToRad));
+
+    // atan2(tanTy, tanTx) put into the range 0 - 2PI.
+    Float4 q = atan4(div4(tanTy, tanTx));
+    Float4 az = select4(gt4(tanTx, zero),
+                        select4(lt4(q, zero), add4(q, set4(6.28318530717958647692f)), q),
+                        add4(q, set4(3.14159265358979323846f)));
+
+    // atan(sin(azimuth) / tanTy) == atan(1 / |(tanTx, tanTy)|).
+    Float4 al = atan4(div4(set4(1), sqrt4(add4(mul4(tanTx, tanTx), mul4(tanTy, tanTy)))));
+
+    Float4 azDeg = mul4(az, radToDeg);
+    Float4 alDeg = mul4(al, radToDeg);
+
+    // Edge cases where tan(...) is undefined.
+    azDeg = select4(txIsZero, select4(gt4(ty, zero), set4(90), set4(270)), azDeg);
+    alDeg = select4(txIsZero, ty, alDeg);
+    azDeg = select4(tyIsZero, select4(gt4(tx, zero), zero, set4(180)), azDeg);
+    alDeg = select4(tyIsZero, tx, alDeg);
+
+    Float4 bothAreZero = and4(txIsZero, tyIsZero);
+    azDeg = select4(bothAreZero, zero, azDeg);
+    alDeg = select4(bothAreZero, zero, alDeg);
+
+    store4(azimuthDeg, azDeg);
+    store4(altitudeDeg, alDeg);
+    return true;
+}
+
+
+#endif
+
+
+} // namespace
+
+
+void Point::toAzimuthAltitudeDeg(const float* tiltXDeg,
+                                 const float* tiltYDeg,
+                                 float* azimuthDeg,
+                                 float* altitudeDeg,
+                                 std::size_t size)
+{
+    std::size_t i = 0;
+
+#if defined(OFX_POINTER_SIMD_SSE2) || defined(OFX_POINTER_SIMD_NEON)
+    for (; i + 4 <= size; i += 4)
+    {
+        if (!toAzimuthAltitudeDeg4(tiltXDeg + i, tiltYDeg + i, azimuthDeg + i, altitudeDeg + i))
+        {
+            for (std::size_t j = i; j < i + 4; ++j)
+                toAzimuthAltitudeDeg(tiltXDeg[j], tiltYDeg[j], azimuthDeg[j], altitudeDeg[j]);
+        }
+    }
+
+    // Pad the remainder so that all values go through the same path.
+    if (i < size)
+    {
+        float tx[4] = { 0, 0, 0, 0 };
+        float ty[4] = { 0, 0, 0, 0 };
+        float az[4];
+        float al[4];
+
+        std::copy(tiltXDeg + i, tiltXDeg + size, tx);
+        std::copy(tiltYDeg + i, tiltYDeg + size, ty);
+
+        if (toAzimuthAltitudeDeg4(tx, ty, az, al))
+        {
+            std::copy(az, az + (size - i), azimuthDeg + i);
+            std::copy(al, al + (size - i), altitudeDeg + i);
+            i = size;
+        }
+    }
+#endif
+
+    for (; i < size; ++i)
+        toAzimuthAltitudeDeg(tiltXDeg[i], tiltYDeg[i], azimuthDeg[i], altitudeDeg[i]);
+}
+
+
+const PointShape& Point::shape() const
+{
+    return _shape;
+}
+
+
+void Point::toAxisAlignedBounds(ConstSpan<Point> points, ofRectangle* bounds)
+{
+    std::size_t i = 0;
+
+#if defined(OFX_POINTER_SIMD_SSE2) || defined(OFX_POINTER_SIMD_NEON)
+    for (; i + 4 <= points.size(); i += 4)
+    {
+        float isRectangle[4];
+        float widths[4];
+        float heights[4];
+        float anglesDeg[4];
+
+        for (std::size_t j = 0; j < 4; ++j)
+        {
+            const auto& shape = points[i + j]._shape;
+            isRectangle[j] = shape._shapeType == PointShape::ShapeType::RECTANGLE ? 1 : 0;
+            widths[j] = shape._width;
+            heights[j] = shape._height;
+            anglesDeg[j] = shape._angleDeg;
+        }
+
+        Float4 w;
+        Float4 h;
+
+        if (toAxisAlignedSize4(eq4(load4(isRectangle), set4(1)),
+                               load4(widths),
+                               load4(heights),
+                               load4(anglesDeg),
+                               w,
+                               h))
+        {
+            store4(widths, w);
+            store4(heights, h);
+        }
+        else
+        {
+            for (std::size_t j = 0; j < 4; ++j)
+            {
+                const auto& shape = points[i + j]._shape;
+                PointShape::toAxisAlignedSize(shape._shapeType,
+                                              shape._width,
+                                              shape._height,
+                                              shape._angleDeg,
+                                              widths[j],
+                                              heights[j]);
+            }
+        }
+
+        for (std::size_t j = 0; j < 4; ++j)
+        {
+            const auto& position = points[i + j]._position;
+            bounds[i + j] = ofRectangle(position.x - widths[j] / 2,
+                                        position.y - heights[j] / 2,
+                                        widths[j],
+                                        heights[j]);
+        }
+    }
+#endif
+
+    for (; i < points.size(); ++i)
+    {
+        const auto& shape = points[i]._shape;
+        const auto& position = points[i]._position;
+        float width = 0;
+        float height = 0;
+        PointShape::toAxisAlignedSize(shape._shapeType,
+                                      shape._width,
+                                      shape._height,
+                                      shape._angleDeg,
+                                      width,
+                                      height);
+        bounds[i] = ofRectangle(position.x - width / 2,
+                                position.y - height / 2,
+                                width,
+                                height);
+    }
+}
+
+
+ofRectangle Point::axisAlignedBounds(ConstSpan<Point> points)
+{
+    if (points.empty())
+        return ofRectangle();
+
+    float minX = std::numeric_limits<float>::max();
+    float minY = std::numeric_limits<float>::max();
+    float maxX = std::numeric_limits<float>::lowest();
+    float maxY = std::numeric_limits<float>::lowest();
+
+    // Process in small blocks to avoid allocating.
+    const std::size_t BLOCK_SIZE = 32;
+    ofRectangle bounds[BLOCK_SIZE];
+
+    for (std::size_t i = 0; i < points.size(); i += BLOCK_SIZE)
+    {
+        std::size_t size = std::min(BLOCK_SIZE, points.size() - i);
+        toAxisAlignedBounds(ConstSpan<Point>(points.data() + i, size), bounds);
+
+        for (std::size_t j = 0; j < size; ++j)
+        {
+            const auto& b = bounds[j];
+            minX = std::min(minX, std::min(b.x, b.x + b.width));
+            maxX = std::max(maxX, std::max(b.x, b.x + b.width));
+            minY = std::min(minY, std::min(b.y, b.y + b.height));
+            maxY = std::max(maxY, std::max(b.y, b.y + b.height));
+        }
+    }
+
+    return ofRectangle(minX, minY, maxX - minX, maxY - minY);
+}
+
+
+PointerInputState PointerInputState::fromGlobalState()
+{
+    PointerInputState state;
+
+    state.modifiers |= ofGetKeyPressed(OF_KEY_CONTROL) ? OF_KEY_CONTROL : 0;
+    state.modifiers |= ofGetKeyPressed(OF_KEY_ALT)     ? OF_KEY_ALT     : 0;
+    state.modifiers |= ofGetKeyPressed(OF_KEY_SHIFT)   ? OF_KEY_SHIFT   : 0;
+    state.modifiers |= ofGetKeyPressed(OF_KEY_SUPER)   ? OF_KEY_SUPER   : 0;
+
+    state.buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_1) ? (1 << OF_MOUSE_BUTTON_1) : 0;
+    state.buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_2) ? (1 << OF_MOUSE_BUTTON_2) : 0;
+    state.buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_3) ? (1 << OF_MOUSE_BUTTON_3) : 0;
+    state.buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_4) ? (1 << OF_MOUSE_BUTTON_4) : 0;
+    state.buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_5) ? (1 << OF_MOUSE_BUTTON_5) : 0;
+    state.buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_6) ? (1 << OF_MOUSE_BUTTON_6) : 0;
+    state.buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_7) ? (1 << OF_MOUSE_BUTTON_7) : 0;
+
+    return state;
+}
+
+
+const std::string PointerEventArgs::TYPE_MOUSE    = "mouse";
+const std::string PointerEventArgs::TYPE_PEN      = "pen";
+const std::string PointerEventArgs::TYPE_TOUCH    = "touch";
+const std::string PointerEventArgs::TYPE_UNKNOWN  = "unknown";
+
+const std::string PointerEventArgs::POINTER_OVER   = "pointerover";
+const std::string PointerEventArgs::POINTER_ENTER  = "pointerenter";
+const std::string PointerEventArgs::POINTER_DOWN   = "pointerdown";
+const std::string PointerEventArgs::POINTER_MOVE   = "pointermove";
+const std::string PointerEventArgs::POINTER_UP     = "pointerup";
+const std::string PointerEventArgs::POINTER_CANCEL = "pointercancel";
+const std::string PointerEventArgs::POINTER_UPDATE = "pointerupdate";
+const std::string PointerEventArgs::POINTER_OUT    = "pointerout";
+const std::string PointerEventArgs::POINTER_LEAVE  = "pointerleave";
+const std::string PointerEventArgs::POINTER_SCROLL = "pointerscroll";
 
 const std::string PointerEventArgs::GOT_POINTER_CAPTURE  = "gotpointercapture";
 const std::string PointerEventArgs::LOST_POINTER_CAPTURE = "lostpointercapture";
@@ -413,6 +1345,54 @@ const std::string PointerEventArgs::PROPERTY_POSITION = "PROPERTY_POSITION";
 const std::string PointerEventArgs::PROPERTY_PRESSURE = "PROPERTY_PRESSURE";
 const std::string PointerEventArgs::PROPERTY_TILT_X = "PROPERTY_TILT_X";
 const std::string PointerEventArgs::PROPERTY_TILT_Y = "PROPERTY_TILT_Y";
+const std::string PointerEventArgs::PROPERTY_TWIST = "PROPERTY_TWIST";
+
+
+namespace {
+
+
+/// \brief Event type strings indexed by PointerEventArgs::EventKind.
+const std::string* const EVENT_TYPES[] = {
+    &EventArgs::EVENT_TYPE_UNKNOWN,
+    &PointerEventArgs::POINTER_OVER,
+    &PointerEventArgs::POINTER_ENTER,
+    &PointerEventArgs::POINTER_DOWN,
+    &PointerEventArgs::POINTER_MOVE,
+    &PointerEventArgs::POINTER_UP,
+    &PointerEventArgs::POINTER_CANCEL,
+    &PointerEventArgs::POINTER_UPDATE,
+    &PointerEventArgs::POINTER_OUT,
+    &PointerEventArgs::POINTER_LEAVE,
+    &PointerEventArgs::POINTER_SCROLL,
+    &PointerEventArgs::GOT_POINTER_CAPTURE,
+    &PointerEventArgs::LOST_POINTER_CAPTURE,
+    &EventArgs::EVENT_TYPE_UNKNOWN
+};
+
+
+/// \brief Device type strings indexed by PointerEventArgs::DeviceKind.
+const std::string* const DEVICE_TYPES[] = {
+    &PointerEventArgs::TYPE_UNKNOWN,
+    &PointerEventArgs::TYPE_MOUSE,
+    &PointerEventArgs::TYPE_PEN,
+    &PointerEventArgs::TYPE_TOUCH,
+    &PointerEventArgs::TYPE_UNKNOWN
+};
+
+
+} // namespace
+
+
+const std::string& to_string(PointerEventArgs::EventKind v)
+{
+    return *EVENT_TYPES[static_cast<std::size_t>(v)];
+}
+
+
+const std::string& to_string(PointerEventArgs::DeviceKind v)
+{
+    return *DEVICE_TYPES[static_cast<std::size_t>(v)];
+}
 
 
 PointerEventArgs::PointerEventArgs()
@@ -422,26 +1402,45 @@ PointerEventArgs::PointerEventArgs()
 
 PointerEventArgs::PointerEventArgs(const std::string& eventType,
                                    const PointerEventArgs& event):
-    PointerEventArgs(event.eventSource(),
-                     eventType,
-                     event.timestampMicros(),
-                     event.detail(),
-                     event.point(),
-                     event.pointerId(),
-                     event.deviceId(),
-                     event.pointerIndex(),
-                     event.sequenceIndex(),
-                     event.deviceType(),
-                     event.isCoalesced(),
-                     event.isPredicted(),
-                     event.isPrimary(),
-                     event.button(),
-                     event.buttons(),
-                     event.modifiers(),
-                     event.coalescedPointerEvents(),
-                     event.predictedPointerEvents(),
-                     event.estimatedProperties(),
-                     event.estimatedPropertiesExpectingUpdates())
+    PointerEventArgs(_intern(eventType), toEventKind(eventType), event)
+{
+    _samples = event._samples;
+    _numCoalescedSamples = event._numCoalescedSamples;
+}
+
+
+PointerEventArgs::PointerEventArgs(EventKind eventKind,
+                                   const PointerEventArgs& event):
+    PointerEventArgs(EVENT_TYPES[static_cast<std::size_t>(eventKind)], eventKind, event)
+{
+    _samples = event._samples;
+    _numCoalescedSamples = event._numCoalescedSamples;
+}
+
+
+PointerEventArgs::PointerEventArgs(const std::string* eventType,
+                                   EventKind eventKind,
+                                   const PointerEventArgs& event):
+    EventArgs(event.eventSource(),
+              eventType,
+              event.timestampMicros(),
+              event.detail()),
+    _point(event._point),
+    _pointerId(event._pointerId),
+    _deviceId(event._deviceId),
+    _pointerIndex(event._pointerIndex),
+    _sequenceIndex(event._sequenceIndex),
+    _eventKind(eventKind),
+    _deviceKind(event._deviceKind),
+    _deviceType(event._deviceType),
+    _isCoalesced(event._isCoalesced),
+    _isPredicted(event._isPredicted),
+    _isPrimary(event._isPrimary),
+    _button(event._button),
+    _buttons(event._buttons),
+    _modifiers(event._modifiers),
+    _estimatedPropertyFlags(event._estimatedPropertyFlags),
+    _estimatedPropertyFlagsExpectingUpdates(event._estimatedPropertyFlagsExpectingUpdates)
 {
 }
 
@@ -472,18 +1471,61 @@ PointerEventArgs::PointerEventArgs(const void* eventSource,
     _deviceId(deviceId),
     _pointerIndex(pointerIndex),
     _sequenceIndex(sequenceIndex),
-    _deviceType(deviceType),
+    _eventKind(toEventKind(eventType)),
+    _deviceKind(toDeviceKind(deviceType)),
+    _deviceType(_deviceKind == DeviceKind::CUSTOM ? _intern(deviceType) : DEVICE_TYPES[static_cast<std::size_t>(_deviceKind)]),
+    _isCoalesced(isCoalesced),
+    _isPredicted(isPredicted),
+    _isPrimary(isPrimary),
+    _button(button),
+    _buttons(buttons),
+    _modifiers(modifiers),
+    _estimatedPropertyFlags(toPropertyFlags(estimatedProperties)),
+    _estimatedPropertyFlagsExpectingUpdates(toPropertyFlags(estimatedPropertiesExpectingUpdates))
+{
+    _setSamples(coalescedPointerEvents, predictedPointerEvents);
+}
+
+
+PointerEventArgs::PointerEventArgs(const void* eventSource,
+                                   EventKind eventKind,
+                                   uint64_t timestampMicros,
+                                   uint64_t detail,
+                                   const Point& point,
+                                   std::size_t pointerId,
+                                   int64_t deviceId,
+                                   int64_t pointerIndex,
+                                   uint64_t sequenceIndex,
+                                   DeviceKind deviceKind,
+                                   bool isCoalesced,
+                                   bool isPredicted,
+                                   bool isPrimary,
+                                   int16_t button,
+                                   uint16_t buttons,
+                                   uint16_t modifiers,
+                                   ConstSpan<PointerEventArgs> coalescedPointerEvents,
+                                   ConstSpan<PointerEventArgs> predictedPointerEvents,
+                                   uint16_t estimatedPropertyFlags,
+                                   uint16_t estimatedPropertyFlagsExpectingUpdates):
+    EventArgs(eventSource, EVENT_TYPES[static_cast<std::size_t>(eventKind)], timestampMicros, detail),
+    _point(point),
+    _pointerId(pointerId),
+    _deviceId(deviceId),
+    _pointerIndex(pointerIndex),
+    _sequenceIndex(sequenceIndex),
+    _eventKind(eventKind),
+    _deviceKind(deviceKind),
+    _deviceType(DEVICE_TYPES[static_cast<std::size_t>(deviceKind)]),
     _isCoalesced(isCoalesced),
     _isPredicted(isPredicted),
     _isPrimary(isPrimary),
     _button(button),
     _buttons(buttons),
     _modifiers(modifiers),
-    _coalescedPointerEvents(coalescedPointerEvents),
-    _predictedPointerEvents(predictedPointerEvents),
-    _estimatedProperties(estimatedProperties),
-    _estimatedPropertiesExpectingUpdates(estimatedPropertiesExpectingUpdates)
+    _estimatedPropertyFlags(estimatedPropertyFlags),
+    _estimatedPropertyFlagsExpectingUpdates(estimatedPropertyFlagsExpectingUpdates)
 {
+    _setSamples(coalescedPointerEvents, predictedPointerEvents);
 }
 
 
@@ -492,15 +1534,15 @@ PointerEventArgs::~PointerEventArgs()
 }
 
 
-Point PointerEventArgs::point() const
+const Point& PointerEventArgs::point() const
 {
     return _point;
 }
 
 
-glm::vec2 PointerEventArgs::position() const
+const glm::vec2& PointerEventArgs::position() const
 {
-    return point().position();
+    return _point.position();
 }
 
 
@@ -534,9 +1576,21 @@ std::size_t PointerEventArgs::pointerId() const
 //}
 
 
-std::string PointerEventArgs::deviceType() const
+const std::string& PointerEventArgs::deviceType() const
+{
+    return *_deviceType;
+}
+
+
+PointerEventArgs::EventKind PointerEventArgs::eventKind() const
+{
+    return _eventKind;
+}
+
+
+PointerEventArgs::DeviceKind PointerEventArgs::deviceKind() const
 {
-    return _deviceType;
+    return _deviceKind;
 }
 
 
@@ -560,7 +1614,7 @@ bool PointerEventArgs::isPrimary() const
 
 bool PointerEventArgs::isEstimated() const
 {
-    return !_estimatedProperties.empty();
+    return _estimatedPropertyFlags != PROPERTY_FLAG_NONE;
 }
 
 
@@ -582,27 +1636,40 @@ uint16_t PointerEventArgs::modifiers() const
 }
 
 
-std::vector<PointerEventArgs> PointerEventArgs::coalescedPointerEvents() const
+ConstSpan<PointerEventArgs> PointerEventArgs::coalescedPointerEvents() const
 {
-    return _coalescedPointerEvents;
+    return ConstSpan<PointerEventArgs>(_samples.data(), _numCoalescedSamples);
 }
 
 
-std::vector<PointerEventArgs> PointerEventArgs::predictedPointerEvents() const
+ConstSpan<PointerEventArgs> PointerEventArgs::predictedPointerEvents() const
 {
-    return _predictedPointerEvents;
+    return ConstSpan<PointerEventArgs>(_samples.data() + _numCoalescedSamples,
+                                       _samples.size() - _numCoalescedSamples);
 }
 
 
 std::set<std::string> PointerEventArgs::estimatedProperties() const
 {
-    return _estimatedProperties;
+    return toPropertySet(_estimatedPropertyFlags);
 }
 
 
 std::set<std::string> PointerEventArgs::estimatedPropertiesExpectingUpdates() const
 {
-    return _estimatedPropertiesExpectingUpdates;
+    return toPropertySet(_estimatedPropertyFlagsExpectingUpdates);
+}
+
+
+uint16_t PointerEventArgs::estimatedPropertyFlags() const
+{
+    return _estimatedPropertyFlags;
+}
+
+
+uint16_t PointerEventArgs::estimatedPropertyFlagsExpectingUpdates() const
+{
+    return _estimatedPropertyFlagsExpectingUpdates;
 }
 
 
@@ -620,54 +1687,74 @@ bool PointerEventArgs::updateEstimatedPropertiesWithEvent(const PointerEventArgs
         return false;
     }
 
-    auto newEstimatedProperties = e.estimatedProperties();
-    std::vector<std::string> propertiesToUpdate;
+    // Properties that were expecting updates and are no longer estimated.
+    uint16_t propertiesToUpdate = _estimatedPropertyFlagsExpectingUpdates & ~e._estimatedPropertyFlags;
+
+    if (propertiesToUpdate & PROPERTY_FLAG_PRESSURE)
+    {
+        _point._pressure = e._point._pressure;
+        std::string property = PROPERTY_PRESSURE;
+        ofNotifyEvent(pointerPropertyUpdate, property, this);
+    }
 
-    std::set_difference(_estimatedPropertiesExpectingUpdates.begin(),
-                        _estimatedPropertiesExpectingUpdates.end(),
-                        newEstimatedProperties.begin(),
-                        newEstimatedProperties.end(),
-                        std::inserter(propertiesToUpdate, propertiesToUpdate.begin()));
+    if (propertiesToUpdate & PROPERTY_FLAG_TILT_X)
+    {
+        _point._tiltXDeg = e._point._tiltXDeg;
+        _point._azimuthAltitudeCached = false;
+        std::string property = PROPERTY_TILT_X;
+        ofNotifyEvent(pointerPropertyUpdate, property, this);
+    }
 
-    for (auto& property: propertiesToUpdate)
+    if (propertiesToUpdate & PROPERTY_FLAG_TILT_Y)
     {
-        if (property == PointerEventArgs::PROPERTY_PRESSURE)
-        {
-            _point._pressure = e.point().pressure();
-            ofNotifyEvent(pointerPropertyUpdate, property, this);
-        }
-        else if (property == PointerEventArgs::PROPERTY_TILT_X)
-        {
-            _point._tiltXDeg = e.point().tiltXDeg();
-            _point._azimuthAltitudeCached = false;
-            ofNotifyEvent(pointerPropertyUpdate, property, this);
-        }
-        else if (property == PointerEventArgs::PROPERTY_TILT_Y)
-        {
-            _point._tiltYDeg = e.point().tiltYDeg();
-            _point._azimuthAltitudeCached = false;
-            ofNotifyEvent(pointerPropertyUpdate, property, this);
-        }
-        else if (property == PointerEventArgs::PROPERTY_POSITION)
-        {
-            _point._position = e.point().position();
-            _point._precisePosition = e.point().precisePosition();
-            ofNotifyEvent(pointerPropertyUpdate, property, this);
-        }
-        else
-        {
-            ofLogWarning("PointerEventArgs::updateEstimatedPropertiesWithEvent") << "Unknown property to update: " << property;
-        }
+        _point._tiltYDeg = e._point._tiltYDeg;
+        _point._azimuthAltitudeCached = false;
+        std::string property = PROPERTY_TILT_Y;
+        ofNotifyEvent(pointerPropertyUpdate, property, this);
+    }
 
-        _estimatedPropertiesExpectingUpdates.erase(property);
+    if (propertiesToUpdate & PROPERTY_FLAG_POSITION)
+    {
+        _point._position = e._point._position;
+        _point._precisePosition = e._point._precisePosition;
+        std::string property = PROPERTY_POSITION;
+        ofNotifyEvent(pointerPropertyUpdate, property, this);
+    }
+
+    if (propertiesToUpdate & PROPERTY_FLAG_TWIST)
+    {
+        _point._twistDeg = e._point._twistDeg;
+        std::string property = PROPERTY_TWIST;
+        ofNotifyEvent(pointerPropertyUpdate, property, this);
     }
 
+    _estimatedPropertyFlagsExpectingUpdates &= ~propertiesToUpdate;
+
     return true;
 }
 
 
 PointerEventArgs PointerEventArgs::toPointerEventArgs(const void* eventSource,
                                                       const ofTouchEventArgs& e)
+{
+    PointerEventArgs event;
+    toPointerEventArgs(eventSource, e, event);
+    return event;
+}
+
+
+void PointerEventArgs::toPointerEventArgs(const void* eventSource,
+                                          const ofTouchEventArgs& e,
+                                          PointerEventArgs& event)
+{
+    toPointerEventArgs(eventSource, e, PointerInputState::fromGlobalState(), event);
+}
+
+
+void PointerEventArgs::toPointerEventArgs(const void* eventSource,
+                                          const ofTouchEventArgs& e,
+                                          const PointerInputState& inputState,
+                                          PointerEventArgs& event)
 {
     // If major or minor axis is defined, then use them, otherwise, use width
     // and height. If neither are defined, use 1 and 1.
@@ -684,16 +1771,11 @@ PointerEventArgs PointerEventArgs::toPointerEventArgs(const void* eventSource,
                      0,
                      e.angle);
 
-    uint16_t modifiers = 0;
-
-    modifiers |= ofGetKeyPressed(OF_KEY_CONTROL) ? OF_KEY_CONTROL : 0;
-    modifiers |= ofGetKeyPressed(OF_KEY_ALT)     ? OF_KEY_ALT     : 0;
-    modifiers |= ofGetKeyPressed(OF_KEY_SHIFT)   ? OF_KEY_SHIFT   : 0;
-    modifiers |= ofGetKeyPressed(OF_KEY_SUPER)   ? OF_KEY_SUPER   : 0;
+    uint16_t modifiers = inputState.modifiers;
 
-    uint64_t timestampMicros = ofGetElapsedTimeMicros();
+    uint64_t timestampMicros = EventArgs::nowMicros();
 
-    std::string eventType = EVENT_TYPE_UNKNOWN;
+    EventKind eventKind = EventKind::UNKNOWN;
 
     uint64_t detail = 0;
 
@@ -711,18 +1793,18 @@ PointerEventArgs PointerEventArgs::toPointerEventArgs(const void* eventSource,
             // Pointers don't use this event. We use gestures for this.
             break;
         case ofTouchEventArgs::down:
-            eventType = POINTER_DOWN;
+            eventKind = EventKind::POINTER_DOWN;
             buttons |= (1 << OF_MOUSE_BUTTON_1);
             break;
         case ofTouchEventArgs::up:
-            eventType = POINTER_UP;
+            eventKind = EventKind::POINTER_UP;
             break;
         case ofTouchEventArgs::move:
             buttons |= (1 << OF_MOUSE_BUTTON_1);
-            eventType = POINTER_MOVE;
+            eventKind = EventKind::POINTER_MOVE;
             break;
         case ofTouchEventArgs::cancel:
-            eventType = POINTER_CANCEL;
+            eventKind = EventKind::POINTER_CANCEL;
             break;
     }
 
@@ -735,114 +1817,101 @@ PointerEventArgs PointerEventArgs::toPointerEventArgs(const void* eventSource,
 
     // Since we can't know for sure, we assume TOUCH because it came from a
     // ofTouchEventArgs.
-    std::string deviceType = PointerEventArgs::TYPE_TOUCH;
+    DeviceKind deviceKind = DeviceKind::TOUCH;
 
     bool isCoalesced = false;
     bool isPredicted = false;
     bool isPrimary = (e.id == 0);
 
-    std::size_t pointerId = 0;
-    hash_combine(pointerId, deviceId);
-    hash_combine(pointerId, e.id);
-    hash_combine(pointerId, deviceType);
+    std::size_t pointerId = toSourcePointerId(deviceKind, deviceId, e.id);
 
     int64_t sequenceIndex = 0;
 
-    PointerEventArgs event(eventSource,
-                           eventType,
-                           timestampMicros,
-                           detail,
-                           point,
-                           pointerId,
-                           deviceId,
-                           e.id,
-                           sequenceIndex,
-                           deviceType,
-                           isCoalesced,
-                           isPredicted,
-                           isPrimary,
-                           button,
-                           buttons,
-                           modifiers,
-                           {},
-                           {},
-                           {},
-                           {});
-
-    return PointerEventArgs(eventSource,
-                            eventType,
-                            timestampMicros,
-                            detail,
-                            point,
-                            pointerId,
-                            deviceId,
-                            e.id,
-                            sequenceIndex,
-                            deviceType,
-                            isCoalesced,
-                            isPredicted,
-                            isPrimary,
-                            button,
-                            buttons,
-                            modifiers,
-                            { event },
-                            {},
-                            {},
-                            {});
+    event._assign(eventSource,
+                  eventKind,
+                  timestampMicros,
+                  detail,
+                  point,
+                  pointerId,
+                  deviceId,
+                  e.id,
+                  sequenceIndex,
+                  deviceKind,
+                  isCoalesced,
+                  isPredicted,
+                  isPrimary,
+                  button,
+                  buttons,
+                  modifiers,
+                  PROPERTY_FLAG_NONE,
+                  PROPERTY_FLAG_NONE);
+
+    // The event is its own coalesced event.
+    event._setSamplesToSelf();
 }
 
 
 PointerEventArgs PointerEventArgs::toPointerEventArgs(const void* eventSource,
                                                       const ofMouseEventArgs& e)
 {
-    // We begin with an unknown event type.
-    std::string eventType = EVENT_TYPE_UNKNOWN;
+    PointerEventArgs event;
+    toPointerEventArgs(eventSource, e, event);
+    return event;
+}
+
+
+void PointerEventArgs::toPointerEventArgs(const void* eventSource,
+                                          const ofMouseEventArgs& e,
+                                          PointerEventArgs& event)
+{
+    toPointerEventArgs(eventSource, e, PointerInputState::fromGlobalState(), event);
+}
+
+
+void PointerEventArgs::toPointerEventArgs(const void* eventSource,
+                                          const ofMouseEventArgs& e,
+                                          const PointerInputState& inputState,
+                                          PointerEventArgs& event)
+{
+    // We begin with an unknown event kind.
+    EventKind eventKind = EventKind::UNKNOWN;
     uint64_t detail = 0;
 
-    // Convert the ofMouseEventArgs type to a string event type.
+    // Convert the ofMouseEventArgs type to an event kind.
     switch (e.type)
     {
         case ofMouseEventArgs::Pressed:
-            eventType = POINTER_DOWN;
+            eventKind = EventKind::POINTER_DOWN;
             break;
         case ofMouseEventArgs::Dragged:
         case ofMouseEventArgs::Moved:
-            eventType = POINTER_MOVE;
+            eventKind = EventKind::POINTER_MOVE;
             break;
         case ofMouseEventArgs::Released:
-            eventType = POINTER_UP;
+            eventKind = EventKind::POINTER_UP;
             break;
         case ofMouseEventArgs::Scrolled:
-            eventType = POINTER_SCROLL;
+            eventKind = EventKind::POINTER_SCROLL;
             break;
         case ofMouseEventArgs::Entered:
             // This is with respect to the source window.
-            eventType = POINTER_ENTER;
+            eventKind = EventKind::POINTER_ENTER;
             break;
         case ofMouseEventArgs::Exited:
             // This is with respect to the source window.
-            eventType = POINTER_LEAVE;
+            eventKind = EventKind::POINTER_LEAVE;
             break;
     }
 
     // Record a timestamp.
-    uint64_t timestampMicros = ofGetElapsedTimeMicros();
+    uint64_t timestampMicros = EventArgs::nowMicros();
 
     // TODO https://www.w3.org/TR/pointerevents/#the-button-property
     // This is not correctly implemented.
     // Note the mouse button associated with this event.
     int16_t button = -1;
 
-    // Calculate buttons.
-    uint16_t buttons = 0;
-
-    buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_1) ? (1 << OF_MOUSE_BUTTON_1) : 0;
-    buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_2) ? (1 << OF_MOUSE_BUTTON_2) : 0;
-    buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_3) ? (1 << OF_MOUSE_BUTTON_3) : 0;
-    buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_4) ? (1 << OF_MOUSE_BUTTON_4) : 0;
-    buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_5) ? (1 << OF_MOUSE_BUTTON_5) : 0;
-    buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_6) ? (1 << OF_MOUSE_BUTTON_6) : 0;
-    buttons |= ofGetMousePressed(OF_MOUSE_BUTTON_7) ? (1 << OF_MOUSE_BUTTON_7) : 0;
+    uint16_t buttons = inputState.buttons;
 
     // Create the point, if a button is pressed, the pressure is 0.5.
     Point point(glm::vec2(e.x, e.y), PointShape(), (buttons > 0 ? 0.5 : 0));
@@ -851,106 +1920,476 @@ PointerEventArgs PointerEventArgs::toPointerEventArgs(const void* eventSource,
     bool isPredicted = false;
     bool isPrimary = true; // A mouse is primary.
 
-    // Calculate modifiers.
-    uint16_t modifiers = 0;
-
-    modifiers |= ofGetKeyPressed(OF_KEY_CONTROL) ? OF_KEY_CONTROL : 0;
-    modifiers |= ofGetKeyPressed(OF_KEY_ALT)     ? OF_KEY_ALT     : 0;
-    modifiers |= ofGetKeyPressed(OF_KEY_SHIFT)   ? OF_KEY_SHIFT   : 0;
-    modifiers |= ofGetKeyPressed(OF_KEY_SUPER)   ? OF_KEY_SUPER   : 0;
+    uint16_t modifiers = inputState.modifiers;
 
     std::size_t deviceId = 0;
     int64_t pointerIndex = 0;
     uint64_t sequenceIndex = 0;
 
-    std::string deviceType = PointerEventArgs::TYPE_MOUSE;
+    DeviceKind deviceKind = DeviceKind::MOUSE;
+
+    std::size_t pointerId = toSourcePointerId(deviceKind, deviceId, pointerIndex);
+
+    event._assign(eventSource,
+                  eventKind,
+                  timestampMicros,
+                  detail,
+                  point,
+                  pointerId,
+                  deviceId,
+                  pointerIndex,
+                  sequenceIndex,
+                  deviceKind,
+                  isCoalesced,
+                  isPredicted,
+                  isPrimary,
+                  button,
+                  buttons,
+                  modifiers,
+                  PROPERTY_FLAG_NONE,
+                  PROPERTY_FLAG_NONE);
+
+    // The event is its own coalesced event.
+    event._setSamplesToSelf();
+}
+
 
-    std::size_t pointerId = 0;
-    hash_combine(pointerId, deviceId);
-    hash_combine(pointerId, pointerIndex);
-    hash_combine(pointerId, deviceType);
+PointerEventArgs PointerEventArgs::toPointerEventArgs(const void* eventSource,
+                                                      const PointerSample& sample)
+{
+    Point point(sample.position,
+                sample.precisePosition,
+                PointShape(),
+                sample.pressure,
+                0,
+                sample.twistDeg,
+                sample.tiltXDeg,
+                sample.tiltYDeg);
 
     PointerEventArgs event(eventSource,
-                           eventType,
-                           timestampMicros,
-                           detail,
+                           sample.eventKind,
+                           sample.timestampMicros,
+                           0,
                            point,
-                           pointerId,
-                           deviceId,
-                           pointerIndex,
-                           sequenceIndex,
-                           deviceType,
-                           isCoalesced,
-                           isPredicted,
-                           isPrimary,
-                           button,
-                           buttons,
-                           modifiers,
+                           sample.pointerId,
+                           0,
+                           0,
+                           sample.sequenceIndex,
+                           sample.deviceKind,
+                           sample.isCoalesced(),
+                           sample.isPredicted(),
+                           sample.isPrimary(),
+                           -1,
+                           sample.buttons,
+                           0,
                            {},
                            {},
-                           {},
-                           {});
-
-    return PointerEventArgs(eventSource,
-                            eventType,
-                            timestampMicros,
-                            detail,
-                            point,
-                            pointerId,
-                            deviceId,
-                            pointerIndex,
-                            sequenceIndex,
-                            deviceType,
-                            isCoalesced,
-                            isPredicted,
-                            isPrimary,
-                            button,
-                            buttons,
-                            modifiers,
-                            { event },
-                            {},
-                            {},
-                            {});
-}
-
-
-PointerEvents::PointerEvents(ofAppBaseWindow* source): _source(source)
-{
-    ofCoreEvents* eventSource = nullptr;
-
-    if (_source)
-    {
-        eventSource = &_source->events();
-    }
-    else
-    {
-        eventSource = &ofEvents();
-    }
+                           sample.estimatedPropertyFlags,
+                           sample.estimatedPropertyFlagsExpectingUpdates);
 
-#if !defined(TARGET_OF_IOS) && !defined(TARGET_ANDROID)
-    _mouseMovedListener = eventSource->mouseMoved.newListener(this, &PointerEvents::onMouseEvent, OF_EVENT_ORDER_BEFORE_APP);
-    _mouseDraggedListener = eventSource->mouseDragged.newListener(this, &PointerEvents::onMouseEvent, OF_EVENT_ORDER_BEFORE_APP);
-    _mousePressedListener = eventSource->mousePressed.newListener(this, &PointerEvents::onMouseEvent, OF_EVENT_ORDER_BEFORE_APP);
-    _mouseReleasedListener = eventSource->mouseReleased.newListener(this, &PointerEvents::onMouseEvent, OF_EVENT_ORDER_BEFORE_APP);
-    _mouseScrolledListener = eventSource->mouseScrolled.newListener(this, &PointerEvents::onMouseEvent, OF_EVENT_ORDER_BEFORE_APP);
-    _mouseEnteredListener = eventSource->mouseEntered.newListener(this, &PointerEvents::onMouseEvent, OF_EVENT_ORDER_BEFORE_APP);
-    _mouseExitedListener = eventSource->mouseExited.newListener(this, &PointerEvents::onMouseEvent, OF_EVENT_ORDER_BEFORE_APP);
-#endif
-    _touchDownListener = eventSource->touchDown.newListener(this, &PointerEvents::onTouchEvent, OF_EVENT_ORDER_BEFORE_APP);
-    _touchUpListener = eventSource->touchUp.newListener(this, &PointerEvents::onTouchEvent, OF_EVENT_ORDER_BEFORE_APP);
-    _touchMovedListener = eventSource->touchMoved.newListener(this, &PointerEvents::onTouchEvent, OF_EVENT_ORDER_BEFORE_APP);
-    _touchDoubleTapListener = eventSource->touchDoubleTap.newListener(this, &PointerEvents::onTouchEvent, OF_EVENT_ORDER_BEFORE_APP);
-    _touchCancelledListener = eventSource->touchCancelled.newListener(this, &PointerEvents::onTouchEvent, OF_EVENT_ORDER_BEFORE_APP);
+    // As with mouse and touch events, the event is its own coalesced sample.
+    event._setSamplesToSelf();
 
+    return event;
 }
 
 
-PointerEvents::~PointerEvents()
+PointerSample PointerEventArgs::toPointerSample() const
 {
+    PointerSample sample;
+    sample.timestampMicros = timestampMicros();
+    sample.pointerId = _pointerId;
+    sample.sequenceIndex = _sequenceIndex;
+    sample.position = _point._position;
+    sample.precisePosition = _point._precisePosition;
+    sample.pressure = _point._pressure;
+    sample.twistDeg = _point._twistDeg;
+    sample.tiltXDeg = _point._tiltXDeg;
+    sample.tiltYDeg = _point._tiltYDeg;
+    sample.buttons = _buttons;
+    sample.eventKind = _eventKind;
+    sample.deviceKind = _deviceKind;
+    sample.flags = (_isCoalesced ? PointerSample::FLAG_COALESCED : 0)
+                 | (_isPredicted ? PointerSample::FLAG_PREDICTED : 0)
+                 | (_isPrimary ? PointerSample::FLAG_PRIMARY : 0);
+    sample.estimatedPropertyFlags = static_cast<uint8_t>(_estimatedPropertyFlags);
+    sample.estimatedPropertyFlagsExpectingUpdates = static_cast<uint8_t>(_estimatedPropertyFlagsExpectingUpdates);
+    return sample;
 }
 
 
-bool PointerEvents::onPointerEvent(const void* source, PointerEventArgs& e)
+std::size_t PointerEventArgs::toSourcePointerId(DeviceKind deviceKind,
+                                                int64_t deviceId,
+                                                int64_t pointerIndex)
+{
+    const std::size_t numBits = std::numeric_limits<std::size_t>::digits;
+    const std::size_t indexMask = (std::size_t(1) << (numBits - 4)) - 1;
+
+    // The top bit marks a source id, the next three hold the device kind.
+    std::size_t id = std::size_t(1) << (numBits - 1);
+    id |= (std::size_t(deviceKind) & 7) << (numBits - 4);
+    id |= ((std::size_t(deviceId) << (numBits / 2)) ^ std::size_t(pointerIndex)) & indexMask;
+    return id;
+}
+
+
+PointerEventArgs::EventKind PointerEventArgs::toEventKind(const std::string& eventType)
+{
+    for (std::size_t i = 0; i < static_cast<std::size_t>(EventKind::CUSTOM); ++i)
+    {
+        if (*EVENT_TYPES[i] == eventType)
+            return static_cast<EventKind>(i);
+    }
+
+    return EventKind::CUSTOM;
+}
+
+
+PointerEventArgs::DeviceKind PointerEventArgs::toDeviceKind(const std::string& deviceType)
+{
+    for (std::size_t i = 0; i < static_cast<std::size_t>(DeviceKind::CUSTOM); ++i)
+    {
+        if (*DEVICE_TYPES[i] == deviceType)
+            return static_cast<DeviceKind>(i);
+    }
+
+    return DeviceKind::CUSTOM;
+}
+
+
+uint16_t PointerEventArgs::toPropertyFlags(const std::set<std::string>& properties)
+{
+    uint16_t result = PROPERTY_FLAG_NONE;
+
+    for (const auto& property: properties)
+    {
+        if (property == PROPERTY_POSITION)
+            result |= PROPERTY_FLAG_POSITION;
+        else if (property == PROPERTY_PRESSURE)
+            result |= PROPERTY_FLAG_PRESSURE;
+        else if (property == PROPERTY_TILT_X)
+            result |= PROPERTY_FLAG_TILT_X;
+        else if (property == PROPERTY_TILT_Y)
+            result |= PROPERTY_FLAG_TILT_Y;
+        else if (property == PROPERTY_TWIST)
+            result |= PROPERTY_FLAG_TWIST;
+        else
+            ofLogWarning("PointerEventArgs::toPropertyFlags") << "Unknown property: " << property;
+    }
+
+    return result;
+}
+
+
+std::set<std::string> PointerEventArgs::toPropertySet(uint16_t propertyFlags)
+{
+    std::set<std::string> result;
+
+    if (propertyFlags & PROPERTY_FLAG_POSITION)
+        result.insert(PROPERTY_POSITION);
+
+    if (propertyFlags & PROPERTY_FLAG_PRESSURE)
+        result.insert(PROPERTY_PRESSURE);
+
+    if (propertyFlags & PROPERTY_FLAG_TILT_X)
+        result.insert(PROPERTY_TILT_X);
+
+    if (propertyFlags & PROPERTY_FLAG_TILT_Y)
+        result.insert(PROPERTY_TILT_Y);
+
+    if (propertyFlags & PROPERTY_FLAG_TWIST)
+        result.insert(PROPERTY_TWIST);
+
+    return result;
+}
+
+
+void PointerEventArgs::_setSamples(ConstSpan<PointerEventArgs> coalescedPointerEvents,
+                                   ConstSpan<PointerEventArgs> predictedPointerEvents)
+{
+    _samples.clear();
+    _samples.reserve(coalescedPointerEvents.size() + predictedPointerEvents.size());
+
+    // Samples are copied without their own samples to keep storage flat.
+    for (const auto& e: coalescedPointerEvents)
+        _samples.push_back(PointerEventArgs(&e.eventType(), e._eventKind, e));
+
+    for (const auto& e: predictedPointerEvents)
+        _samples.push_back(PointerEventArgs(&e.eventType(), e._eventKind, e));
+
+    _numCoalescedSamples = coalescedPointerEvents.size();
+}
+
+
+void PointerEventArgs::_setSamplesToSelf()
+{
+    // Resizing from one to one keeps the existing sample and its storage.
+    _samples.resize(1);
+
+    PointerEventArgs& sample = _samples[0];
+    sample._assignWithoutSamples(*this);
+    sample._samples.clear();
+    sample._numCoalescedSamples = 0;
+
+    _numCoalescedSamples = 1;
+}
+
+
+void PointerEventArgs::_coalesce(const PointerEventArgs& event)
+{
+    // Make sure this event is represented by at least one coalesced sample.
+    if (_numCoalescedSamples == 0)
+        _samples.insert(_samples.begin(), PointerEventArgs(&eventType(), _eventKind, *this));
+    else
+        _samples.erase(_samples.begin() + _numCoalescedSamples, _samples.end());
+
+    const auto coalesced = event.coalescedPointerEvents();
+    const auto predicted = event.predictedPointerEvents();
+
+    _samples.reserve(_samples.size() + std::max(coalesced.size(), std::size_t(1)) + predicted.size());
+
+    if (coalesced.empty())
+        _samples.push_back(PointerEventArgs(&event.eventType(), event._eventKind, event));
+
+    for (const auto& e: coalesced)
+        _samples.push_back(PointerEventArgs(&e.eventType(), e._eventKind, e));
+
+    _numCoalescedSamples = _samples.size();
+
+    for (const auto& e: predicted)
+        _samples.push_back(PointerEventArgs(&e.eventType(), e._eventKind, e));
+
+    _assignWithoutSamples(event);
+}
+
+
+void PointerEventArgs::_assignWithoutSamples(const PointerEventArgs& event)
+{
+    _set(event.eventSource(),
+         &event.eventType(),
+         event.timestampMicros(),
+         event.detail());
+    _point = event._point;
+    _pointerId = event._pointerId;
+    _deviceId = event._deviceId;
+    _pointerIndex = event._pointerIndex;
+    _sequenceIndex = event._sequenceIndex;
+    _eventKind = event._eventKind;
+    _deviceKind = event._deviceKind;
+    _deviceType = event._deviceType;
+    _isCoalesced = event._isCoalesced;
+    _isPredicted = event._isPredicted;
+    _isPrimary = event._isPrimary;
+    _button = event._button;
+    _buttons = event._buttons;
+    _modifiers = event._modifiers;
+    _estimatedPropertyFlags = event._estimatedPropertyFlags;
+    _estimatedPropertyFlagsExpectingUpdates = event._estimatedPropertyFlagsExpectingUpdates;
+}
+
+
+void PointerEventArgs::_assignWithoutSamples(EventKind eventKind,
+                                             const PointerEventArgs& event)
+{
+    _assignWithoutSamples(event);
+    _set(event.eventSource(),
+         EVENT_TYPES[static_cast<std::size_t>(eventKind)],
+         event.timestampMicros(),
+         event.detail());
+    _eventKind = eventKind;
+    _samples.clear();
+    _numCoalescedSamples = 0;
+}
+
+
+void PointerEventArgs::_assign(const void* eventSource,
+                               EventKind eventKind,
+                               uint64_t timestampMicros,
+                               uint64_t detail,
+                               const Point& point,
+                               std::size_t pointerId,
+                               int64_t deviceId,
+                               int64_t pointerIndex,
+                               uint64_t sequenceIndex,
+                               DeviceKind deviceKind,
+                               bool isCoalesced,
+                               bool isPredicted,
+                               bool isPrimary,
+                               int16_t button,
+                               uint16_t buttons,
+                               uint16_t modifiers,
+                               uint16_t estimatedPropertyFlags,
+                               uint16_t estimatedPropertyFlagsExpectingUpdates)
+{
+    _set(eventSource,
+         EVENT_TYPES[static_cast<std::size_t>(eventKind)],
+         timestampMicros,
+         detail);
+    _point = point;
+    _pointerId = pointerId;
+    _deviceId = deviceId;
+    _pointerIndex = pointerIndex;
+    _sequenceIndex = sequenceIndex;
+    _eventKind = eventKind;
+    _deviceKind = deviceKind;
+    _deviceType = DEVICE_TYPES[static_cast<std::size_t>(deviceKind)];
+    _isCoalesced = isCoalesced;
+    _isPredicted = isPredicted;
+    _isPrimary = isPrimary;
+    _button = button;
+    _buttons = buttons;
+    _modifiers = modifiers;
+    _estimatedPropertyFlags = estimatedPropertyFlags;
+    _estimatedPropertyFlagsExpectingUpdates = estimatedPropertyFlagsExpectingUpdates;
+}
+
+
+bool PointerSample::updateEstimatedPropertiesWithEvent(const PointerEventArgs& e)
+{
+    if (e.sequenceIndex() == 0 || sequenceIndex == 0)
+    {
+        ofLogVerbose("PointerSample::updateEstimatedPropertiesWithEvent") << "One or more of the sequence indices are zero.";
+        return false;
+    }
+
+    if (e.sequenceIndex() != sequenceIndex)
+    {
+        ofLogVerbose("PointerSample::updateEstimatedPropertiesWithEvent") << "Sequence indices do not match.";
+        return false;
+    }
+
+    // Properties that were expecting updates and are no longer estimated.
+    uint16_t propertiesToUpdate = estimatedPropertyFlagsExpectingUpdates & ~e.estimatedPropertyFlags();
+
+    const Point& point = e.point();
+
+    if (propertiesToUpdate & PointerEventArgs::PROPERTY_FLAG_PRESSURE)
+        pressure = point.pressure();
+
+    if (propertiesToUpdate & PointerEventArgs::PROPERTY_FLAG_TILT_X)
+        tiltXDeg = point.tiltXDeg();
+
+    if (propertiesToUpdate & PointerEventArgs::PROPERTY_FLAG_TILT_Y)
+        tiltYDeg = point.tiltYDeg();
+
+    if (propertiesToUpdate & PointerEventArgs::PROPERTY_FLAG_POSITION)
+    {
+        position = point.position();
+        precisePosition = point.precisePosition();
+    }
+
+    if (propertiesToUpdate & PointerEventArgs::PROPERTY_FLAG_TWIST)
+        twistDeg = point.twistDeg();
+
+    estimatedPropertyFlagsExpectingUpdates &= ~propertiesToUpdate;
+
+    return true;
+}
+
+
+bool PointerEventFilter::matches(const PointerEventArgs& e) const
+{
+    return matchesEventKind(e.eventKind())
+        && (deviceKindMask & toMask(e.deviceKind())) != 0
+        && (!primaryOnly || e.isPrimary())
+        && (!hasPointerId || e.pointerId() == pointerId);
+}
+
+
+bool PointerEventFilter::matchesEventKind(PointerEventArgs::EventKind eventKind) const
+{
+    return (eventKindMask & toMask(eventKind)) != 0;
+}
+
+
+bool PointerEventFilter::operator == (const PointerEventFilter& other) const
+{
+    return deviceKindMask == other.deviceKindMask
+        && eventKindMask == other.eventKindMask
+        && primaryOnly == other.primaryOnly
+        && hasPointerId == other.hasPointerId
+        && (!hasPointerId || pointerId == other.pointerId);
+}
+
+
+uint32_t PointerEventFilter::toMask(PointerEventArgs::DeviceKind deviceKind)
+{
+    return 1u << static_cast<uint32_t>(deviceKind);
+}
+
+
+uint32_t PointerEventFilter::toMask(PointerEventArgs::EventKind eventKind)
+{
+    return 1u << static_cast<uint32_t>(eventKind);
+}
+
+
+PointerEvents::PointerEvents(ofAppBaseWindow* source,
+                             std::size_t postedEventCapacity):
+    _postedEventCapacity(postedEventCapacity),
+    _postedSamples(postedEventCapacity),
+    _source(source)
+{
+    typedef PointerEventArgs::EventKind EventKind;
+
+    std::fill(std::begin(_typedEvents), std::end(_typedEvents), nullptr);
+    _typedEvents[static_cast<std::size_t>(EventKind::POINTER_OVER)] = &pointerOver;
+    _typedEvents[static_cast<std::size_t>(EventKind::POINTER_ENTER)] = &pointerEnter;
+    _typedEvents[static_cast<std::size_t>(EventKind::POINTER_DOWN)] = &pointerDown;
+    _typedEvents[static_cast<std::size_t>(EventKind::POINTER_MOVE)] = &pointerMove;
+    _typedEvents[static_cast<std::size_t>(EventKind::POINTER_UP)] = &pointerUp;
+    _typedEvents[static_cast<std::size_t>(EventKind::POINTER_CANCEL)] = &pointerCancel;
+    _typedEvents[static_cast<std::size_t>(EventKind::POINTER_UPDATE)] = &pointerUpdate;
+    _typedEvents[static_cast<std::size_t>(EventKind::POINTER_OUT)] = &pointerOut;
+    _typedEvents[static_cast<std::size_t>(EventKind::POINTER_LEAVE)] = &pointerLeave;
+    _typedEvents[static_cast<std::size_t>(EventKind::POINTER_SCROLL)] = &pointerScroll;
+    _typedEvents[static_cast<std::size_t>(EventKind::GOT_POINTER_CAPTURE)] = &gotPointerCapture;
+    _typedEvents[static_cast<std::size_t>(EventKind::LOST_POINTER_CAPTURE)] = &lostPointerCapture;
+
+    ofCoreEvents* eventSource = nullptr;
+
+    if (_source)
+    {
+        eventSource = &_source->events();
+    }
+    else
+    {
+        eventSource = &ofEvents();
+    }
+
+#if !defined(TARGET_OF_IOS) && !defined(TARGET_ANDROID)
+    _mouseMovedListener = eventSource->mouseMoved.newListener(this, &PointerEvents::onMouseEvent, OF_EVENT_ORDER_BEFORE_APP);
+    _mouseDraggedListener = eventSource->mouseDragged.newListener(this, &PointerEvents::onMouseEvent, OF_EVENT_ORDER_BEFORE_APP);
+    _mousePressedListener = eventSource->mousePressed.newListener(this, &PointerEvents::onMouseEvent, OF_EVENT_ORDER_BEFORE_APP);
+    _mouseReleasedListener = eventSource->mouseReleased.newListener(this, &PointerEvents::onMouseEvent, OF_EVENT_ORDER_BEFORE_APP);
+    _mouseScrolledListener = eventSource->mouseScrolled.newListener(this, &PointerEvents::onMouseEvent, OF_EVENT_ORDER_BEFORE_APP);
+    _mouseEnteredListener = eventSource->mouseEntered.newListener(this, &PointerEvents::onMouseEvent, OF_EVENT_ORDER_BEFORE_APP);
+    _mouseExitedListener = eventSource->mouseExited.newListener(this, &PointerEvents::onMouseEvent, OF_EVENT_ORDER_BEFORE_APP);
+#endif
+    _touchDownListener = eventSource->touchDown.newListener(this, &PointerEvents::onTouchEvent, OF_EVENT_ORDER_BEFORE_APP);
+    _touchUpListener = eventSource->touchUp.newListener(this, &PointerEvents::onTouchEvent, OF_EVENT_ORDER_BEFORE_APP);
+    _touchMovedListener = eventSource->touchMoved.newListener(this, &PointerEvents::onTouchEvent, OF_EVENT_ORDER_BEFORE_APP);
+    _touchDoubleTapListener = eventSource->touchDoubleTap.newListener(this, &PointerEvents::onTouchEvent, OF_EVENT_ORDER_BEFORE_APP);
+    _touchCancelledListener = eventSource->touchCancelled.newListener(this, &PointerEvents::onTouchEvent, OF_EVENT_ORDER_BEFORE_APP);
+    _keyPressedListener = eventSource->keyPressed.newListener(this, &PointerEvents::onKeyEvent, OF_EVENT_ORDER_BEFORE_APP);
+    _keyReleasedListener = eventSource->keyReleased.newListener(this, &PointerEvents::onKeyEvent, OF_EVENT_ORDER_BEFORE_APP);
+    _updateListener = eventSource->update.newListener(this, &PointerEvents::onUpdate, OF_EVENT_ORDER_BEFORE_APP);
+
+    // Start with the current state. It is updated incrementally from here on.
+    _inputState = PointerInputState::fromGlobalState();
+
+    for (std::size_t i = 0; i < MAX_ACTIVE_POINTERS; ++i)
+        _freePointerIds[i] = static_cast<uint8_t>(i);
+}
+
+
+PointerEvents::~PointerEvents()
+{
+    delete _postedEvents.load(std::memory_order_acquire);
+}
+
+
+bool PointerEvents::onPointerEvent(const void* source, PointerEventArgs& e)
 {
     return _dispatchPointerEvent(source, e);
 }
@@ -958,10 +2397,29 @@ bool PointerEvents::onPointerEvent(const void* source, PointerEventArgs& e)
 
 bool PointerEvents::onMouseEvent(const void* source, ofMouseEventArgs& e)
 {
+    if (e.button >= 0 && e.button < 16)
+    {
+        if (e.type == ofMouseEventArgs::Pressed)
+            _inputState.buttons |= (1 << e.button);
+        else if (e.type == ofMouseEventArgs::Released)
+            _inputState.buttons &= ~(1 << e.button);
+    }
+
     // We use _source here because ofMouseEventArgs events aren't currently
     // delivered with a source.
-    auto p = PointerEventArgs::toPointerEventArgs(_source, e);
-    return _dispatchPointerEvent(source, p);
+    if (_isDispatchingConvertedEvent)
+    {
+        // A listener caused a nested event, so don't reuse _convertedEvent.
+        PointerEventArgs p;
+        PointerEventArgs::toPointerEventArgs(_source, e, _inputState, p);
+        return _dispatchPointerEvent(source, p);
+    }
+
+    PointerEventArgs::toPointerEventArgs(_source, e, _inputState, _convertedEvent);
+    _isDispatchingConvertedEvent = true;
+    bool result = _dispatchPointerEvent(source, _convertedEvent);
+    _isDispatchingConvertedEvent = false;
+    return result;
 }
 
 
@@ -969,162 +2427,2377 @@ bool PointerEvents::onTouchEvent(const void* source, ofTouchEventArgs& e)
 {
     // We use _source here because ofTouchEventArgs events aren't currently
     // delivered with a source.
-    auto p = PointerEventArgs::toPointerEventArgs(_source, e);
-    return _dispatchPointerEvent(source, p);
-}
-
+    if (_isDispatchingConvertedEvent)
+    {
+        // A listener caused a nested event, so don't reuse _convertedEvent.
+        PointerEventArgs p;
+        PointerEventArgs::toPointerEventArgs(_source, e, _inputState, p);
+        return _dispatchPointerEvent(source, p);
+    }
 
-//void PointerEvents::disableLegacyEvents()
-//{
-//    _consumeLegacyEvents = true;
-//}
-//
-//
-//void PointerEvents::enableLegacyEvents()
-//{
-//    _consumeLegacyEvents = false;
-//}
+    PointerEventArgs::toPointerEventArgs(_source, e, _inputState, _convertedEvent);
+    _isDispatchingConvertedEvent = true;
+    bool result = _dispatchPointerEvent(source, _convertedEvent);
+    _isDispatchingConvertedEvent = false;
+    return result;
+}
 
 
-bool PointerEvents::_dispatchPointerEvent(const void* source, PointerEventArgs& e)
+bool PointerEvents::onKeyEvent(const void*, ofKeyEventArgs& e)
 {
-    // TODO: Update this when openFrameworks core supports source on events.
-    if (source && source != _source)
-    {
-        // "Event source sent, but does not match window. PointerEvents should be updated to respect source."
-        assert(false);
-        ofLogError("PointerEvents::_dispatchPointerEvent") << "Mismatched source.";
-        return false;
-    }
+    uint8_t keyBit = 0;
 
-    if (e.eventType() == PointerEventArgs::EVENT_TYPE_UNKNOWN)
+    switch (e.key)
     {
-        // We don't deliver unknown event types.
-        // These are usually double-tap events from OF core.
-        return true;
+        case OF_KEY_LEFT_CONTROL:  keyBit = 1 << 0; break;
+        case OF_KEY_RIGHT_CONTROL: keyBit = 1 << 1; break;
+        case OF_KEY_LEFT_ALT:      keyBit = 1 << 2; break;
+        case OF_KEY_RIGHT_ALT:     keyBit = 1 << 3; break;
+        case OF_KEY_LEFT_SHIFT:    keyBit = 1 << 4; break;
+        case OF_KEY_RIGHT_SHIFT:   keyBit = 1 << 5; break;
+        case OF_KEY_LEFT_SUPER:    keyBit = 1 << 6; break;
+        case OF_KEY_RIGHT_SUPER:   keyBit = 1 << 7; break;
+        default:
+            return false;
     }
 
-    // All pointer events get dispatched via pointerEvent.
-    bool consumed = ofNotifyEvent(pointerEvent, e, _source);
+    if (e.type == ofKeyEventArgs::Pressed)
+        _pressedModifierKeys |= keyBit;
+    else
+        _pressedModifierKeys &= ~keyBit;
 
-    // If the pointer was not consumed, then send it along to the standard five.
-    if (!consumed)
+    uint16_t modifiers = 0;
+
+    modifiers |= (_pressedModifierKeys & 0x03) ? OF_KEY_CONTROL : 0;
+    modifiers |= (_pressedModifierKeys & 0x0C) ? OF_KEY_ALT     : 0;
+    modifiers |= (_pressedModifierKeys & 0x30) ? OF_KEY_SHIFT   : 0;
+    modifiers |= (_pressedModifierKeys & 0xC0) ? OF_KEY_SUPER   : 0;
+
+    _inputState.modifiers = modifiers;
+
+    return false;
+}
+
+
+const PointerInputState& PointerEvents::inputState() const
+{
+    return _inputState;
+}
+
+
+void PointerEvents::onUpdate(ofEventArgs&)
+{
+    flush();
+}
+
+
+void PointerEvents::setFrameBatchingEnabled(bool enabled)
+{
+    if (!enabled)
+        flush();
+
+    _isFrameBatchingEnabled = enabled;
+}
+
+
+bool PointerEvents::isFrameBatchingEnabled() const
+{
+    return _isFrameBatchingEnabled;
+}
+
+
+void PointerEvents::flush()
+{
+    // Events posted or queued by listeners during a flush wait for the next
+    // flush.
+    if (_isFlushing)
+        return;
+
+    _isFlushing = true;
+
+    // Posted events go through _dispatchPointerEvent, so they are queued
+    // here if frame batching is enabled.
+    _dispatchPostedEvents();
+
+    // If a listener disables frame batching, events it queued meanwhile are
+    // delivered now, before any event that is no longer queued.
+    while (!_queuedEvents.empty())
     {
-        if (e.eventType() == PointerEventArgs::POINTER_DOWN)
-        {
-            consumed = ofNotifyEvent(pointerDown, e, _source);
-        }
-        else if (e.eventType() == PointerEventArgs::POINTER_UP)
-        {
-            consumed = ofNotifyEvent(pointerUp, e, _source);
-        }
-        else if (e.eventType() == PointerEventArgs::POINTER_MOVE)
+        std::swap(_queuedEvents, _flushedEvents);
+
+        for (auto& e: _flushedEvents)
         {
-            consumed = ofNotifyEvent(pointerMove, e, _source);
+            _updateActivePointers(e);
+            _notifyPointerEvent(e);
         }
-        else if (e.eventType() == PointerEventArgs::POINTER_CANCEL)
+
+        _flushedEvents.clear();
+
+        if (_isFrameBatchingEnabled)
+            break;
+    }
+
+    _isFlushing = false;
+}
+
+
+bool PointerEvents::postPointerEvent(const PointerEventArgs& e)
+{
+    auto queue = _postedEvents.load(std::memory_order_acquire);
+
+    if (!queue)
+    {
+        // Producers may race to create the queue. The loser deletes its own.
+        auto newQueue = new BoundedMPSCQueue<PointerEventArgs>(_postedEventCapacity);
+
+        if (_postedEvents.compare_exchange_strong(queue,
+                                                  newQueue,
+                                                  std::memory_order_acq_rel,
+                                                  std::memory_order_acquire))
         {
-            consumed = ofNotifyEvent(pointerCancel, e, _source);
+            queue = newQueue;
         }
-        else if (e.eventType() == PointerEventArgs::POINTER_UPDATE)
+        else
         {
-            consumed = ofNotifyEvent(pointerUpdate, e, _source);
+            delete newQueue;
         }
     }
 
-    return _consumeLegacyEvents || consumed;
+    if (queue->push(e))
+    {
+        _postedEventCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    _droppedEventCount.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+
+bool PointerEvents::postPointerSample(const PointerSample& sample)
+{
+    if (_postedSamples.push(sample))
+    {
+        _postedEventCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    _droppedEventCount.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+
+uint64_t PointerEvents::postedEventCount() const
+{
+    return _postedEventCount.load(std::memory_order_relaxed);
+}
+
+
+uint64_t PointerEvents::droppedEventCount() const
+{
+    return _droppedEventCount.load(std::memory_order_relaxed);
+}
+
+
+void PointerEvents::_dispatchPostedEvents()
+{
+    // Drain at most one queue's worth of each, so that producers that keep
+    // posting can't hold the consumer here.
+    PointerSample sample;
+
+    for (std::size_t i = 0; i < _postedSamples.capacity(); ++i)
+    {
+        if (!_postedSamples.pop(sample))
+            break;
+
+        _drainedEvents.push_back(PointerEventArgs::toPointerEventArgs(_source, sample));
+    }
+
+    auto queue = _postedEvents.load(std::memory_order_acquire);
+
+    if (queue)
+    {
+        for (std::size_t i = 0; i < queue->capacity(); ++i)
+        {
+            if (!queue->pop(_poppedEvent))
+                break;
+
+            _drainedEvents.push_back(_poppedEvent);
+        }
+    }
+
+    if (_drainedEvents.empty())
+        return;
+
+    // Each producer posts in order, but producers interleave arbitrarily.
+    std::stable_sort(_drainedEvents.begin(),
+                     _drainedEvents.end(),
+                     [](const PointerEventArgs& a, const PointerEventArgs& b) {
+                         return a.timestampMicros() < b.timestampMicros();
+                     });
+
+    for (auto& e: _drainedEvents)
+        _dispatchPointerEvent(nullptr, e);
+
+    _drainedEvents.clear();
+}
+
+
+void PointerEvents::_queuePointerEvent(const PointerEventArgs& e)
+{
+    if (e.eventKind() == PointerEventArgs::EventKind::POINTER_MOVE)
+    {
+        // Only merge with the last queued event of the same pointer, so that
+        // the order relative to other events of the pointer is preserved.
+        // Queued events still carry their source pointer id.
+        auto riter = _queuedEvents.rbegin();
+        while (riter != _queuedEvents.rend())
+        {
+            if (riter->pointerId() == e.pointerId())
+            {
+                if (riter->eventKind() == PointerEventArgs::EventKind::POINTER_MOVE
+                &&  riter->buttons() == e.buttons())
+                {
+                    riter->_coalesce(e);
+                    return;
+                }
+
+                break;
+            }
+
+            ++riter;
+        }
+    }
+
+    _queuedEvents.push_back(e);
+}
+
+
+//void PointerEvents::disableLegacyEvents()
+//{
+//    _consumeLegacyEvents = true;
+//}
+//
+//
+//void PointerEvents::enableLegacyEvents()
+//{
+//    _consumeLegacyEvents = false;
+//}
+
+
+bool PointerEvents::_dispatchPointerEvent(const void* source, PointerEventArgs& e)
+{
+    // TODO: Update this when openFrameworks core supports source on events.
+    if (source && source != _source)
+    {
+        // "Event source sent, but does not match window. PointerEvents should be updated to respect source."
+        assert(false);
+        ofLogError("PointerEvents::_dispatchPointerEvent") << "Mismatched source.";
+        return false;
+    }
+
+    if (e.eventKind() == PointerEventArgs::EventKind::UNKNOWN)
+    {
+        // We don't deliver unknown event types.
+        // These are usually double-tap events from OF core.
+        return true;
+    }
+
+    // Queued events keep their source pointer id, and the active pointers
+    // are updated when they are delivered, so that listeners see the state
+    // at the time of each event.
+    if (_isFrameBatchingEnabled)
+    {
+        _queuePointerEvent(e);
+        return _consumeLegacyEvents;
+    }
+
+    _updateActivePointers(e);
+    return _notifyPointerEvent(e);
+}
+
+
+bool PointerEvents::_notifyPointerEvent(PointerEventArgs& e)
+{
+    if (!_pendingPointerCaptures.empty())
+        _processPendingPointerCapture(e);
+
+    if (!_pointerCaptures.empty())
+    {
+        auto iter = _pointerCaptures.find(e.pointerId());
+
+        if (iter != _pointerCaptures.end())
+        {
+            // Captured events go to the owner only. Copy the callback, as
+            // the owner may release or replace the capture.
+            PointerCaptureCallback callback = iter->second.callback;
+            bool consumed = callback(e);
+
+            ofNotifyEvent(capturedPointerEvent, e, _source);
+
+            if (e.eventKind() == PointerEventArgs::EventKind::POINTER_UP
+            ||  e.eventKind() == PointerEventArgs::EventKind::POINTER_CANCEL
+            ||  e.eventKind() == PointerEventArgs::EventKind::POINTER_LEAVE)
+            {
+                // Implicit release. A pointer that leaves is removed from
+                // the active pointers and its id may be given to another
+                // pointer, so its capture must not outlive it.
+                _pendingPointerCaptures[e.pointerId()] = PointerCapture();
+                _processPendingPointerCapture(e);
+            }
+
+            return _consumeLegacyEvents || consumed;
+        }
+    }
+
+    bool consumed = _broadcastPointerEvent(e);
+    return _consumeLegacyEvents || consumed;
+}
+
+
+bool PointerEvents::_broadcastPointerEvent(PointerEventArgs& e)
+{
+    // All pointer events get dispatched via pointerEvent.
+    bool consumed = ofNotifyEvent(pointerEvent, e, _source);
+
+    // Then to the filtered events that match it.
+    std::size_t index = static_cast<std::size_t>(e.eventKind());
+
+    if (!consumed && index < NUM_EVENT_KINDS)
+    {
+        // Index rather than iterate, as listeners may request new filters.
+        const auto& filteredEvents = _filteredEventsByKind[index];
+
+        for (std::size_t i = 0; !consumed && i < filteredEvents.size(); ++i)
+        {
+            FilteredEvent* filteredEvent = filteredEvents[i];
+
+            if (filteredEvent->event.size() > 0 && filteredEvent->filter.matches(e))
+                consumed = ofNotifyEvent(filteredEvent->event, e, _source);
+        }
+    }
+
+    // If the pointer was not consumed, then send it along to its typed event.
+    if (!consumed)
+    {
+        ofEvent<PointerEventArgs>* event = typedEvent(e.eventKind());
+
+        if (event)
+            consumed = ofNotifyEvent(*event, e, _source);
+    }
+
+    return consumed;
+}
+
+
+ConstSpan<PointerEvents::ActivePointer> PointerEvents::activePointers() const
+{
+    return ConstSpan<ActivePointer>(_activePointers, _numActivePointers);
+}
+
+
+const PointerEvents::ActivePointer* PointerEvents::activePointer(std::size_t pointerId) const
+{
+    if (pointerId >= MAX_ACTIVE_POINTERS || _activePointerIndices[pointerId] == 0)
+        return nullptr;
+
+    return &_activePointers[_activePointerIndices[pointerId] - 1];
+}
+
+
+void PointerEvents::_updateActivePointers(PointerEventArgs& e)
+{
+    typedef PointerEventArgs::EventKind EventKind;
+    typedef PointerEventArgs::DeviceKind DeviceKind;
+
+    bool isActivating = false;
+
+    switch (e.eventKind())
+    {
+        case EventKind::POINTER_OVER:
+        case EventKind::POINTER_ENTER:
+        case EventKind::POINTER_DOWN:
+        case EventKind::POINTER_MOVE:
+        case EventKind::POINTER_SCROLL:
+            isActivating = true;
+            break;
+        default:
+            break;
+    }
+
+    bool isRemoving = e.eventKind() == EventKind::POINTER_CANCEL
+                   || e.eventKind() == EventKind::POINTER_LEAVE
+                   || (e.eventKind() == EventKind::POINTER_UP && e.deviceKind() != DeviceKind::MOUSE);
+
+    std::size_t slot = _findActivePointerSlot(e.pointerId());
+    ActivePointer* pointer = nullptr;
+
+    if (_activePointerSlots[slot] != 0)
+    {
+        pointer = &_activePointers[_activePointerSlots[slot] - 1];
+    }
+    else
+    {
+        std::size_t numFreePointerIds = MAX_ACTIVE_POINTERS - _numActivePointers;
+
+        if (!isActivating)
+        {
+            // Look for the id of the most recently released pointer with
+            // this source id, if it was not reused yet.
+            for (std::size_t i = numFreePointerIds; i-- > 0;)
+            {
+                std::size_t pointerId = _freePointerIds[(_freePointerIdsBegin + i) % MAX_ACTIVE_POINTERS];
+
+                if (_wasPointerIdUsed[pointerId] && _lastSourcePointerIds[pointerId] == e.pointerId())
+                {
+                    e._pointerId = pointerId;
+
+                    for (auto& sample: e._samples)
+                        sample._pointerId = pointerId;
+
+                    return;
+                }
+            }
+        }
+
+        if (numFreePointerIds == 0)
+        {
+            // Warn once until a pointer is removed, not at input rate.
+            if (!_didActivePointersOverflow)
+            {
+                ofLogWarning("PointerEvents::_updateActivePointers") << "Too many active pointers, dispatching with the source pointer id.";
+                _didActivePointersOverflow = true;
+            }
+
+            return;
+        }
+
+        std::size_t pointerId = _freePointerIds[_freePointerIdsBegin];
+        _freePointerIdsBegin = (_freePointerIdsBegin + 1) % MAX_ACTIVE_POINTERS;
+
+        std::size_t deviceKind = static_cast<std::size_t>(e.deviceKind());
+
+        pointer = &_activePointers[_numActivePointers];
+        *pointer = ActivePointer();
+        pointer->pointerId = pointerId;
+        pointer->sourcePointerId = e.pointerId();
+        pointer->deviceKind = e.deviceKind();
+        pointer->isPrimary = e.deviceKind() == DeviceKind::MOUSE
+                          || _numActivePointersByKind[deviceKind] == 0;
+
+        _lastSourcePointerIds[pointerId] = e.pointerId();
+        _wasPointerIdUsed[pointerId] = true;
+
+        ++_numActivePointers;
+        _activePointerSlots[slot] = static_cast<uint8_t>(_numActivePointers);
+        _activePointerIndices[pointerId] = static_cast<uint8_t>(_numActivePointers);
+        ++_numActivePointersByKind[deviceKind];
+
+        // Events that can't make a pointer active release it again below.
+        isRemoving = isRemoving || !isActivating;
+    }
+
+    pointer->buttons = e.buttons();
+    pointer->position = e.position();
+    pointer->timestampMicros = e.timestampMicros();
+
+    e._pointerId = pointer->pointerId;
+    e._isPrimary = pointer->isPrimary;
+
+    for (auto& sample: e._samples)
+    {
+        sample._pointerId = pointer->pointerId;
+        sample._isPrimary = pointer->isPrimary;
+    }
+
+    if (isRemoving)
+        _removeActivePointer(slot);
+}
+
+
+std::size_t PointerEvents::_findActivePointerSlot(std::size_t sourcePointerId) const
+{
+    std::size_t slot = _toActivePointerSlot(sourcePointerId);
+
+    while (_activePointerSlots[slot] != 0
+       &&  _activePointers[_activePointerSlots[slot] - 1].sourcePointerId != sourcePointerId)
+    {
+        slot = (slot + 1) & (NUM_ACTIVE_POINTER_SLOTS - 1);
+    }
+
+    return slot;
+}
+
+
+void PointerEvents::_removeActivePointer(std::size_t slot)
+{
+    const std::size_t mask = NUM_ACTIVE_POINTER_SLOTS - 1;
+    std::size_t index = _activePointerSlots[slot] - 1;
+
+    // Backward shift deletion keeps probe sequences intact without
+    // tombstones.
+    _activePointerSlots[slot] = 0;
+    std::size_t next = slot;
+
+    for (;;)
+    {
+        next = (next + 1) & mask;
+
+        if (_activePointerSlots[next] == 0)
+            break;
+
+        std::size_t home = _toActivePointerSlot(_activePointers[_activePointerSlots[next] - 1].sourcePointerId);
+
+        // Move the entry if its home is not cyclically in (slot, next].
+        if (((next - home) & mask) >= ((next - slot) & mask))
+        {
+            _activePointerSlots[slot] = _activePointerSlots[next];
+            _activePointerSlots[next] = 0;
+            slot = next;
+        }
+    }
+
+    std::size_t pointerId = _activePointers[index].pointerId;
+
+    // A capture that did not take effect yet is dropped. Pending releases
+    // and active captures are released after the removing event is
+    // delivered, so that the owner receives LOST_POINTER_CAPTURE.
+    auto pending = _pendingPointerCaptures.find(pointerId);
+
+    if (pending != _pendingPointerCaptures.end() && pending->second.owner)
+        _pendingPointerCaptures.erase(pending);
+
+    // Release the id to the back of the free ring.
+    std::size_t numFreePointerIds = MAX_ACTIVE_POINTERS - _numActivePointers;
+    _freePointerIds[(_freePointerIdsBegin + numFreePointerIds) % MAX_ACTIVE_POINTERS] = static_cast<uint8_t>(pointerId);
+    _activePointerIndices[pointerId] = 0;
+
+    --_numActivePointersByKind[static_cast<std::size_t>(_activePointers[index].deviceKind)];
+    --_numActivePointers;
+    _didActivePointersOverflow = false;
+
+    // Move the last pointer into the gap. Its slot still refers to its old
+    // index, which holds the same pointer id, so it can be found.
+    if (index != _numActivePointers)
+    {
+        _activePointers[index] = _activePointers[_numActivePointers];
+        _activePointerSlots[_findActivePointerSlot(_activePointers[index].sourcePointerId)] = static_cast<uint8_t>(index + 1);
+        _activePointerIndices[_activePointers[index].pointerId] = static_cast<uint8_t>(index + 1);
+    }
+}
+
+
+std::size_t PointerEvents::_toActivePointerSlot(std::size_t sourcePointerId)
+{
+    // Fibonacci hashing spreads both hashed and small sequential ids.
+    uint64_t hash = static_cast<uint64_t>(sourcePointerId) * 0x9E3779B97F4A7C15ull;
+    return static_cast<std::size_t>(hash >> 32) & (NUM_ACTIVE_POINTER_SLOTS - 1);
+}
+
+
+void PointerEvents::setPointerCapture(std::size_t pointerId,
+                                      const void* owner,
+                                      PointerCaptureCallback callback)
+{
+    if (!owner || !callback)
+    {
+        ofLogError("PointerEvents::setPointerCapture") << "Invalid owner or callback.";
+        return;
+    }
+
+    if (!activePointer(pointerId))
+    {
+        ofLogError("PointerEvents::setPointerCapture") << "Pointer " << pointerId << " is not active.";
+        return;
+    }
+
+    PointerCapture& capture = _pendingPointerCaptures[pointerId];
+    capture.owner = owner;
+    capture.callback = callback;
+}
+
+
+void PointerEvents::releasePointerCapture(std::size_t pointerId, const void* owner)
+{
+    if (hasPointerCapture(pointerId, owner))
+        _pendingPointerCaptures[pointerId] = PointerCapture();
+}
+
+
+bool PointerEvents::hasPointerCapture(std::size_t pointerId, const void* owner) const
+{
+    if (!owner)
+        return false;
+
+    auto pending = _pendingPointerCaptures.find(pointerId);
+
+    if (pending != _pendingPointerCaptures.end())
+        return pending->second.owner == owner;
+
+    auto iter = _pointerCaptures.find(pointerId);
+    return iter != _pointerCaptures.end() && iter->second.owner == owner;
+}
+
+
+void PointerEvents::_processPendingPointerCapture(const PointerEventArgs& e)
+{
+    auto pending = _pendingPointerCaptures.find(e.pointerId());
+
+    if (pending == _pendingPointerCaptures.end())
+        return;
+
+    PointerCapture next = pending->second;
+    _pendingPointerCaptures.erase(pending);
+
+    PointerCapture previous;
+    auto iter = _pointerCaptures.find(e.pointerId());
+
+    if (iter != _pointerCaptures.end())
+    {
+        previous = iter->second;
+        _pointerCaptures.erase(iter);
+    }
+
+    if (previous.owner == next.owner)
+    {
+        if (next.owner)
+            _pointerCaptures[e.pointerId()] = next;
+
+        return;
+    }
+
+    if (next.owner)
+        _pointerCaptures[e.pointerId()] = next;
+
+    if (previous.owner)
+    {
+        PointerEventArgs lost(PointerEventArgs::EventKind::LOST_POINTER_CAPTURE, e);
+        _notifyPointerCaptureEvent(previous.callback, lost);
+    }
+
+    if (next.owner)
+    {
+        PointerEventArgs got(PointerEventArgs::EventKind::GOT_POINTER_CAPTURE, e);
+        _notifyPointerCaptureEvent(next.callback, got);
+    }
+}
+
+
+void PointerEvents::_notifyPointerCaptureEvent(PointerCaptureCallback& callback,
+                                               PointerEventArgs& e)
+{
+    if (!callback(e))
+        _broadcastPointerEvent(e);
+}
+
+
+ofEvent<PointerEventArgs>& PointerEvents::filteredEvent(const PointerEventFilter& filter)
+{
+    for (auto& filteredEvent: _filteredEvents)
+    {
+        if (filteredEvent->filter == filter)
+            return filteredEvent->event;
+    }
+
+    _filteredEvents.push_back(std::make_unique<FilteredEvent>());
+    FilteredEvent* filteredEvent = _filteredEvents.back().get();
+    filteredEvent->filter = filter;
+
+    for (std::size_t i = 0; i < NUM_EVENT_KINDS; ++i)
+    {
+        if (filter.matchesEventKind(static_cast<PointerEventArgs::EventKind>(i)))
+            _filteredEventsByKind[i].push_back(filteredEvent);
+    }
+
+    return filteredEvent->event;
+}
+
+
+ofEvent<PointerEventArgs>* PointerEvents::typedEvent(PointerEventArgs::EventKind eventKind)
+{
+    std::size_t index = static_cast<std::size_t>(eventKind);
+    return index < NUM_EVENT_KINDS ? _typedEvents[index] : nullptr;
+}
+
+
+PointerCaptureThread::PointerCaptureThread(PointerEvents* events,
+                                           CaptureFunction capture,
+                                           uint64_t idleSleepMicros):
+    _events(events),
+    _capture(capture),
+    _idleSleepMicros(idleSleepMicros)
+{
+}
+
+
+PointerCaptureThread::~PointerCaptureThread()
+{
+    stop();
+}
+
+
+void PointerCaptureThread::start()
+{
+    if (_thread.joinable() || !_events || !_capture)
+        return;
+
+    _isRunning = true;
+    _thread = std::thread(&PointerCaptureThread::_run, this);
+}
+
+
+void PointerCaptureThread::stop()
+{
+    _isRunning = false;
+
+    if (_thread.joinable())
+        _thread.join();
+}
+
+
+bool PointerCaptureThread::isRunning() const
+{
+    return _isRunning;
+}
+
+
+void PointerCaptureThread::_run()
+{
+    while (_isRunning)
+    {
+        PointerSample sample = {};
+        bool hasTimestamp = false;
+
+        if (!_capture(sample, hasTimestamp))
+        {
+            if (_idleSleepMicros > 0)
+                std::this_thread::sleep_for(std::chrono::microseconds(_idleSleepMicros));
+            else
+                std::this_thread::yield();
+
+            continue;
+        }
+
+        // Stamp as close to capture as possible.
+        if (!hasTimestamp)
+            sample.timestampMicros = EventArgs::nowMicros();
+
+        _events->postPointerSample(sample);
+    }
+}
+
+
+const float PointerTargets::DEFAULT_CELL_SIZE = 64;
+
+
+PointerTargets::PointerTargets(PointerEvents* events, float cellSize, int prio):
+    _cellSize(cellSize > 0 ? cellSize : DEFAULT_CELL_SIZE)
+{
+    if (events)
+    {
+        _pointerEventListener = events->pointerEvent.newListener(this, &PointerTargets::onPointerEvent, prio);
+        _capturedPointerEventListener = events->capturedPointerEvent.newListener(this, &PointerTargets::onCapturedPointerEvent, prio);
+    }
+}
+
+
+PointerTargets::~PointerTargets()
+{
+}
+
+
+std::size_t PointerTargets::addTarget(const ofRectangle& bounds,
+                                      Callback callback,
+                                      int zIndex)
+{
+    std::size_t targetId = 0;
+
+    if (!_freeTargetIds.empty())
+    {
+        targetId = _freeTargetIds.back();
+        _freeTargetIds.pop_back();
+    }
+    else
+    {
+        targetId = _targets.size();
+        _targets.push_back(Target());
+    }
+
+    Target& target = _targets[targetId];
+    target.bounds = bounds.getStandardized();
+    target.callback = callback;
+    target.zIndex = zIndex;
+    target.order = _nextOrder++;
+    target.isAlive = true;
+
+    _insert(targetId);
+    ++_size;
+
+    return targetId;
+}
+
+
+void PointerTargets::removeTarget(std::size_t targetId)
+{
+    if (targetId >= _targets.size() || !_targets[targetId].isAlive)
+        return;
+
+    _erase(targetId);
+    _targets[targetId] = Target();
+    _freeTargetIds.push_back(targetId);
+    --_size;
+
+    // Forget the target so that a reused id doesn't inherit its state.
+    for (auto& pointerState: _pointerStates)
+    {
+        PointerState& state = pointerState.second;
+        state.targetIds.erase(std::remove(state.targetIds.begin(),
+                                          state.targetIds.end(),
+                                          targetId),
+                              state.targetIds.end());
+
+        if (state.topTargetId == targetId)
+            state.topTargetId = NO_TARGET;
+    }
+}
+
+
+void PointerTargets::setTargetBounds(std::size_t targetId, const ofRectangle& bounds)
+{
+    if (targetId >= _targets.size() || !_targets[targetId].isAlive)
+        return;
+
+    _erase(targetId);
+    _targets[targetId].bounds = bounds.getStandardized();
+    _insert(targetId);
+}
+
+
+ofRectangle PointerTargets::targetBounds(std::size_t targetId) const
+{
+    if (targetId >= _targets.size() || !_targets[targetId].isAlive)
+        return ofRectangle();
+
+    return _targets[targetId].bounds;
+}
+
+
+std::size_t PointerTargets::size() const
+{
+    return _size;
+}
+
+
+void PointerTargets::hitTest(const ofRectangle& area, std::vector<std::size_t>& targetIds) const
+{
+    targetIds.clear();
+
+    if (_size == 0)
+        return;
+
+    ofRectangle r = area.getStandardized();
+
+    auto test = [&](std::size_t targetId) {
+        const Target& target = _targets[targetId];
+
+        if (target.queryStamp == _queryStamp)
+            return;
+
+        target.queryStamp = _queryStamp;
+
+        if (target.bounds.x <= r.x + r.width
+        &&  r.x <= target.bounds.x + target.bounds.width
+        &&  target.bounds.y <= r.y + r.height
+        &&  r.y <= target.bounds.y + target.bounds.height)
+            targetIds.push_back(targetId);
+    };
+
+    ++_queryStamp;
+
+    int64_t x0, y0, x1, y1;
+    _toCells(r, x0, y0, x1, y1);
+
+    if (static_cast<uint64_t>(x1 - x0 + 1) * static_cast<uint64_t>(y1 - y0 + 1) > _cells.size())
+    {
+        // The area covers more cells than are occupied, so visit those.
+        for (const auto& cell: _cells)
+        {
+            for (std::size_t targetId: cell.second)
+                test(targetId);
+        }
+    }
+    else
+    {
+        for (int64_t y = y0; y <= y1; ++y)
+        {
+            for (int64_t x = x0; x <= x1; ++x)
+            {
+                auto iter = _cells.find(_toKey(x, y));
+
+                if (iter != _cells.end())
+                {
+                    for (std::size_t targetId: iter->second)
+                        test(targetId);
+                }
+            }
+        }
+    }
+
+    for (std::size_t targetId: _largeTargetIds)
+        test(targetId);
+
+    std::sort(targetIds.begin(),
+              targetIds.end(),
+              [this](std::size_t a, std::size_t b) { return _isAbove(a, b); });
+}
+
+
+void PointerTargets::hitTest(const PointerEventArgs& e, std::vector<std::size_t>& targetIds) const
+{
+    hitTest(hitArea(e), targetIds);
+
+    // Refine the bounds candidates with the contact shape.
+    const PointShape& shape = e.point().shape();
+
+    targetIds.erase(std::remove_if(targetIds.begin(),
+                                   targetIds.end(),
+                                   [&](std::size_t targetId) {
+                                       return !shape.intersectsRectangle(e.position(), _targets[targetId].bounds);
+                                   }),
+                    targetIds.end());
+}
+
+
+ofRectangle PointerTargets::hitArea(const PointerEventArgs& e)
+{
+    const PointShape& shape = e.point().shape();
+    float width = shape.axisAlignedWidth();
+    float height = shape.axisAlignedHeight();
+
+    return ofRectangle(e.position().x - width / 2,
+                       e.position().y - height / 2,
+                       width,
+                       height);
+}
+
+
+bool PointerTargets::onPointerEvent(PointerEventArgs& e)
+{
+    typedef PointerEventArgs::EventKind EventKind;
+
+    // Take the scratch storage, so a nested event gets its own.
+    std::vector<std::size_t> targetIds;
+    targetIds.swap(_targetIds);
+
+    bool consumed = false;
+
+    switch (e.eventKind())
+    {
+        case EventKind::POINTER_DOWN:
+        case EventKind::POINTER_MOVE:
+        case EventKind::POINTER_UP:
+        case EventKind::POINTER_UPDATE:
+        case EventKind::POINTER_SCROLL:
+            hitTest(e, targetIds);
+            _updatePointerState(e, targetIds);
+
+            for (std::size_t i = 0; !consumed && i < targetIds.size(); ++i)
+                consumed = _notifyTarget(targetIds[i], e);
+
+            // Pointers that can't hover are gone after they are lifted.
+            if (e.eventKind() == EventKind::POINTER_UP
+            &&  e.deviceKind() != PointerEventArgs::DeviceKind::MOUSE)
+            {
+                targetIds.clear();
+                _updatePointerState(e, targetIds);
+            }
+            break;
+        case EventKind::POINTER_CANCEL:
+        {
+            auto iter = _pointerStates.find(e.pointerId());
+
+            if (iter != _pointerStates.end())
+                targetIds.assign(iter->second.targetIds.begin(), iter->second.targetIds.end());
+
+            for (std::size_t i = 0; !consumed && i < targetIds.size(); ++i)
+                consumed = _notifyTarget(targetIds[i], e);
+
+            targetIds.clear();
+            _updatePointerState(e, targetIds);
+            break;
+        }
+        case EventKind::POINTER_OUT:
+        case EventKind::POINTER_LEAVE:
+            // The pointer left the source window.
+            _updatePointerState(e, targetIds);
+            break;
+        default:
+            break;
+    }
+
+    targetIds.clear();
+    _targetIds.swap(targetIds);
+    return consumed;
+}
+
+
+void PointerTargets::onCapturedPointerEvent(PointerEventArgs& e)
+{
+    typedef PointerEventArgs::EventKind EventKind;
+
+    bool isLeaving = e.eventKind() == EventKind::POINTER_CANCEL
+                  || e.eventKind() == EventKind::POINTER_OUT
+                  || e.eventKind() == EventKind::POINTER_LEAVE
+                  || (e.eventKind() == EventKind::POINTER_UP
+                  &&  e.deviceKind() != PointerEventArgs::DeviceKind::MOUSE);
+
+    // Otherwise the pointer stays over its targets while it is captured.
+    if (!isLeaving)
+        return;
+
+    // Take the scratch storage, so a nested event gets its own.
+    std::vector<std::size_t> targetIds;
+    targetIds.swap(_targetIds);
+    targetIds.clear();
+
+    _updatePointerState(e, targetIds);
+
+    _targetIds.swap(targetIds);
+}
+
+
+void PointerTargets::_updatePointerState(const PointerEventArgs& e,
+                                         const std::vector<std::size_t>& targetIds)
+{
+    std::size_t topTargetId = targetIds.empty() ? NO_TARGET : targetIds.front();
+    std::size_t previousTopTargetId = NO_TARGET;
+
+    // Take the scratch storage, so a nested event gets its own.
+    std::vector<std::size_t> previousTargetIds;
+    previousTargetIds.swap(_previousTargetIds);
+
+    auto iter = _pointerStates.find(e.pointerId());
+
+    if (iter != _pointerStates.end())
+    {
+        previousTopTargetId = iter->second.topTargetId;
+
+        // The state keeps the emptied scratch storage and reuses its capacity.
+        previousTargetIds.swap(iter->second.targetIds);
+
+        if (targetIds.empty())
+        {
+            _pointerStates.erase(iter);
+        }
+        else
+        {
+            iter->second.topTargetId = topTargetId;
+            iter->second.targetIds.assign(targetIds.begin(), targetIds.end());
+        }
+    }
+    else if (!targetIds.empty())
+    {
+        PointerState& state = _pointerStates[e.pointerId()];
+        state.topTargetId = topTargetId;
+        state.targetIds.assign(targetIds.begin(), targetIds.end());
+    }
+
+    auto contains = [](const std::vector<std::size_t>& ids, std::size_t id) {
+        return std::find(ids.begin(), ids.end(), id) != ids.end();
+    };
+
+    // Follow the order of the Pointer Events specification: out, leave, over
+    // and then enter. Leave goes topmost first and enter bottommost first.
+    if (previousTopTargetId != topTargetId && previousTopTargetId != NO_TARGET)
+        _notifyBoundaryEvent(previousTopTargetId, PointerEventArgs::EventKind::POINTER_OUT, e);
+
+    for (std::size_t targetId: previousTargetIds)
+    {
+        if (!contains(targetIds, targetId))
+            _notifyBoundaryEvent(targetId, PointerEventArgs::EventKind::POINTER_LEAVE, e);
+    }
+
+    if (previousTopTargetId != topTargetId && topTargetId != NO_TARGET)
+        _notifyBoundaryEvent(topTargetId, PointerEventArgs::EventKind::POINTER_OVER, e);
+
+    for (auto riter = targetIds.rbegin(); riter != targetIds.rend(); ++riter)
+    {
+        if (!contains(previousTargetIds, *riter))
+            _notifyBoundaryEvent(*riter, PointerEventArgs::EventKind::POINTER_ENTER, e);
+    }
+
+    previousTargetIds.clear();
+    _previousTargetIds.swap(previousTargetIds);
+}
+
+
+void PointerTargets::_notifyBoundaryEvent(std::size_t targetId,
+                                          PointerEventArgs::EventKind eventKind,
+                                          const PointerEventArgs& e)
+{
+    if (_isNotifyingBoundaryEvent)
+    {
+        // A target caused a nested event, so don't reuse _boundaryEvent.
+        PointerEventArgs boundaryEvent;
+        boundaryEvent._assignWithoutSamples(eventKind, e);
+        _notifyTarget(targetId, boundaryEvent);
+        return;
+    }
+
+    _boundaryEvent._assignWithoutSamples(eventKind, e);
+    _isNotifyingBoundaryEvent = true;
+    _notifyTarget(targetId, _boundaryEvent);
+    _isNotifyingBoundaryEvent = false;
+}
+
+
+bool PointerTargets::_notifyTarget(std::size_t targetId, PointerEventArgs& e)
+{
+    if (targetId >= _targets.size() || !_targets[targetId].isAlive)
+        return false;
+
+    // Copy the callback, as the target may be removed by its own callback.
+    Callback callback = _targets[targetId].callback;
+    return callback && callback(e);
+}
+
+
+void PointerTargets::_insert(std::size_t targetId)
+{
+    Target& target = _targets[targetId];
+
+    int64_t x0, y0, x1, y1;
+    _toCells(target.bounds, x0, y0, x1, y1);
+
+    target.isLarge = static_cast<uint64_t>(x1 - x0 + 1) * static_cast<uint64_t>(y1 - y0 + 1) > MAX_CELLS_PER_TARGET;
+
+    if (target.isLarge)
+    {
+        _largeTargetIds.push_back(targetId);
+        return;
+    }
+
+    for (int64_t y = y0; y <= y1; ++y)
+    {
+        for (int64_t x = x0; x <= x1; ++x)
+            _cells[_toKey(x, y)].push_back(targetId);
+    }
+}
+
+
+void PointerTargets::_erase(std::size_t targetId)
+{
+    const Target& target = _targets[targetId];
+
+    auto eraseFrom = [targetId](std::vector<std::size_t>& ids) {
+        auto iter = std::find(ids.begin(), ids.end(), targetId);
+
+        if (iter != ids.end())
+        {
+            *iter = ids.back();
+            ids.pop_back();
+        }
+    };
+
+    if (target.isLarge)
+    {
+        eraseFrom(_largeTargetIds);
+        return;
+    }
+
+    int64_t x0, y0, x1, y1;
+    _toCells(target.bounds, x0, y0, x1, y1);
+
+    for (int64_t y = y0; y <= y1; ++y)
+    {
+        for (int64_t x = x0; x <= x1; ++x)
+        {
+            auto iter = _cells.find(_toKey(x, y));
+
+            if (iter != _cells.end())
+            {
+                eraseFrom(iter->second);
+
+                if (iter->second.empty())
+                    _cells.erase(iter);
+            }
+        }
+    }
+}
+
+
+void PointerTargets::_toCells(const ofRectangle& area,
+                              int64_t& x0,
+                              int64_t& y0,
+                              int64_t& x1,
+                              int64_t& y1) const
+{
+    // Clamp so that huge or non-finite areas can't overflow the cell range.
+    const float limit = static_cast<float>(std::numeric_limits<int32_t>::max() / 2);
+
+    auto toCell = [&](float value) {
+        float cell = std::floor(value / _cellSize);
+        return static_cast<int64_t>(std::isnan(cell) ? 0 : ofClamp(cell, -limit, limit));
+    };
+
+    x0 = toCell(area.x);
+    y0 = toCell(area.y);
+    x1 = toCell(area.x + area.width);
+    y1 = toCell(area.y + area.height);
+}
+
+
+uint64_t PointerTargets::_toKey(int64_t x, int64_t y)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32)
+          | static_cast<uint64_t>(static_cast<uint32_t>(y));
+}
+
+
+bool PointerTargets::_isAbove(std::size_t a, std::size_t b) const
+{
+    const Target& targetA = _targets[a];
+    const Target& targetB = _targets[b];
+
+    if (targetA.zIndex != targetB.zIndex)
+        return targetA.zIndex > targetB.zIndex;
+
+    return targetA.order > targetB.order;
+}
+
+
+PointerEvents* PointerEventsManager::events()
+{
+    return eventsForWindow(nullptr);
+}
+
+
+PointerEvents* PointerEventsManager::eventsForWindow(ofAppBaseWindow* window)
+{
+    auto iter = _windowEventMap.find(window);
+
+    if (iter != _windowEventMap.end())
+    {
+        return iter->second.get();
+    }
+
+    _windowEventMap[window] = std::make_unique<PointerEvents>(window);
+    return _windowEventMap[window].get();
+}
+
+
+PointerEventsManager& PointerEventsManager::instance()
+{
+    static PointerEventsManager instance;
+    return instance;
+}
+
+
+PointerEventsManager::PointerEventsManager()
+{
+}
+
+
+PointerEventsManager::~PointerEventsManager()
+{
+}
+
+
+
+PointerSampleColumns::PointerSampleColumns()
+{
+}
+
+
+PointerSampleColumns::~PointerSampleColumns()
+{
+}
+
+
+std::size_t PointerSampleColumns::size() const
+{
+    return _timestampMicros.size() - _begin;
+}
+
+
+bool PointerSampleColumns::empty() const
+{
+    return size() == 0;
+}
+
+
+void PointerSampleColumns::clear()
+{
+    truncate(0);
+}
+
+
+void PointerSampleColumns::reserve(std::size_t size)
+{
+    size += _begin;
+    _x.reserve(size);
+    _y.reserve(size);
+    _preciseX.reserve(size);
+    _preciseY.reserve(size);
+    _pressure.reserve(size);
+    _twistDeg.reserve(size);
+    _tiltXDeg.reserve(size);
+    _tiltYDeg.reserve(size);
+    _azimuthDeg.reserve(size);
+    _altitudeDeg.reserve(size);
+    _arcLength.reserve(size);
+    _timestampMicros.reserve(size);
+    _pointerId.reserve(size);
+    _sequenceIndex.reserve(size);
+    _buttons.reserve(size);
+    _eventKind.reserve(size);
+    _deviceKind.reserve(size);
+    _flags.reserve(size);
+    _estimatedPropertyFlags.reserve(size);
+    _estimatedPropertyFlagsExpectingUpdates.reserve(size);
+}
+
+
+std::size_t PointerSampleColumns::capacity() const
+{
+    return _timestampMicros.capacity() - _begin;
+}
+
+
+void PointerSampleColumns::push_back(const PointerSample& sample)
+{
+    _push_back(sample);
+    _updateAzimuthAltitude(size() - 1);
+    _updateArcLength(size() - 1);
+}
+
+
+void PointerSampleColumns::append(ConstSpan<PointerEventArgs> events)
+{
+    std::size_t first = size();
+
+    // Grow geometrically, so that repeated appends stay amortized O(1).
+    if (first + events.size() > capacity())
+        reserve(std::max(first + events.size(), capacity() * 2));
+
+    for (const auto& e: events)
+        _push_back(e.toPointerSample());
+
+    _updateAzimuthAltitude(first);
+    _updateArcLength(first);
+}
+
+
+void PointerSampleColumns::_push_back(const PointerSample& sample)
+{
+    _x.push_back(sample.position.x);
+    _y.push_back(sample.position.y);
+    _preciseX.push_back(sample.precisePosition.x);
+    _preciseY.push_back(sample.precisePosition.y);
+    _pressure.push_back(sample.pressure);
+    _twistDeg.push_back(sample.twistDeg);
+    _tiltXDeg.push_back(sample.tiltXDeg);
+    _tiltYDeg.push_back(sample.tiltYDeg);
+    _timestampMicros.push_back(sample.timestampMicros);
+    _pointerId.push_back(sample.pointerId);
+    _sequenceIndex.push_back(sample.sequenceIndex);
+    _buttons.push_back(sample.buttons);
+    _eventKind.push_back(sample.eventKind);
+    _deviceKind.push_back(sample.deviceKind);
+    _flags.push_back(sample.flags);
+    _estimatedPropertyFlags.push_back(sample.estimatedPropertyFlags);
+    _estimatedPropertyFlagsExpectingUpdates.push_back(sample.estimatedPropertyFlagsExpectingUpdates);
+}
+
+
+void PointerSampleColumns::truncate(std::size_t size)
+{
+    if (size >= this->size())
+        return;
+
+    if (size == 0)
+        _begin = 0;
+
+    size += _begin;
+
+    _x.resize(size);
+    _y.resize(size);
+    _preciseX.resize(size);
+    _preciseY.resize(size);
+    _pressure.resize(size);
+    _twistDeg.resize(size);
+    _tiltXDeg.resize(size);
+    _tiltYDeg.resize(size);
+    _azimuthDeg.resize(size);
+    _altitudeDeg.resize(size);
+    _arcLength.resize(size);
+    _timestampMicros.resize(size);
+    _pointerId.resize(size);
+    _sequenceIndex.resize(size);
+    _buttons.resize(size);
+    _eventKind.resize(size);
+    _deviceKind.resize(size);
+    _flags.resize(size);
+    _estimatedPropertyFlags.resize(size);
+    _estimatedPropertyFlagsExpectingUpdates.resize(size);
+}
+
+
+void PointerSampleColumns::eraseFront(std::size_t count)
+{
+    count = std::min(count, size());
+
+    if (count == size())
+    {
+        clear();
+        return;
+    }
+
+    _begin += count;
+
+    // Move the remaining samples to the front once they are outnumbered.
+    if (_begin < size())
+        return;
+
+    std::size_t n = size();
+
+    for (std::size_t i = 0; i < n; ++i)
+        _copy(i, _begin + i);
+
+    _begin = 0;
+    truncate(n);
+}
+
+
+void PointerSampleColumns::eraseFlagged(uint8_t flags)
+{
+    std::size_t n = _begin + size();
+    std::size_t j = _begin;
+
+    // Skip the samples that stay in place.
+    while (j < n && (_flags[j] & flags) == 0)
+        ++j;
+
+    std::size_t first = j - _begin;
+
+    for (std::size_t i = j; i < n; ++i)
+    {
+        if ((_flags[i] & flags) == 0)
+        {
+            _copy(j, i);
+            ++j;
+        }
+    }
+
+    truncate(j - _begin);
+    _updateArcLength(first);
+}
+
+
+void PointerSampleColumns::set(std::size_t index, const PointerSample& sample)
+{
+    bool isMoved = _x[_begin + index] != sample.position.x
+                || _y[_begin + index] != sample.position.y;
+
+    if (isMoved)
+    {
+        _x[_begin + index] = sample.position.x;
+        _y[_begin + index] = sample.position.y;
+        _updateArcLength(index);
+    }
+
+    index += _begin;
+    _preciseX[index] = sample.precisePosition.x;
+    _preciseY[index] = sample.precisePosition.y;
+    _pressure[index] = sample.pressure;
+    _twistDeg[index] = sample.twistDeg;
+    _tiltXDeg[index] = sample.tiltXDeg;
+    _tiltYDeg[index] = sample.tiltYDeg;
+    _timestampMicros[index] = sample.timestampMicros;
+    _pointerId[index] = sample.pointerId;
+    _sequenceIndex[index] = sample.sequenceIndex;
+    _buttons[index] = sample.buttons;
+    _eventKind[index] = sample.eventKind;
+    _deviceKind[index] = sample.deviceKind;
+    _flags[index] = sample.flags;
+    _estimatedPropertyFlags[index] = sample.estimatedPropertyFlags;
+    _estimatedPropertyFlagsExpectingUpdates[index] = sample.estimatedPropertyFlagsExpectingUpdates;
+    Point::toAzimuthAltitudeDeg(&_tiltXDeg[index],
+                                &_tiltYDeg[index],
+                                &_azimuthDeg[index],
+                                &_altitudeDeg[index],
+                                1);
+}
+
+
+PointerSample PointerSampleColumns::operator [] (std::size_t index) const
+{
+    index += _begin;
+    PointerSample sample;
+    sample.timestampMicros = _timestampMicros[index];
+    sample.pointerId = _pointerId[index];
+    sample.sequenceIndex = _sequenceIndex[index];
+    sample.position = { _x[index], _y[index] };
+    sample.precisePosition = { _preciseX[index], _preciseY[index] };
+    sample.pressure = _pressure[index];
+    sample.twistDeg = _twistDeg[index];
+    sample.tiltXDeg = _tiltXDeg[index];
+    sample.tiltYDeg = _tiltYDeg[index];
+    sample.buttons = _buttons[index];
+    sample.eventKind = _eventKind[index];
+    sample.deviceKind = _deviceKind[index];
+    sample.flags = _flags[index];
+    sample.estimatedPropertyFlags = _estimatedPropertyFlags[index];
+    sample.estimatedPropertyFlagsExpectingUpdates = _estimatedPropertyFlagsExpectingUpdates[index];
+    return sample;
+}
+
+
+PointerSample PointerSampleColumns::front() const
+{
+    return (*this)[0];
+}
+
+
+PointerSample PointerSampleColumns::back() const
+{
+    return (*this)[size() - 1];
+}
+
+
+PointerSampleColumns::ConstIterator PointerSampleColumns::begin() const
+{
+    return ConstIterator(this, 0);
+}
+
+
+PointerSampleColumns::ConstIterator PointerSampleColumns::end() const
+{
+    return ConstIterator(this, size());
+}
+
+
+ConstSpan<float> PointerSampleColumns::x() const
+{
+    return ConstSpan<float>(_x.data() + _begin, size());
+}
+
+
+ConstSpan<float> PointerSampleColumns::y() const
+{
+    return ConstSpan<float>(_y.data() + _begin, size());
+}
+
+
+ConstSpan<float> PointerSampleColumns::preciseX() const
+{
+    return ConstSpan<float>(_preciseX.data() + _begin, size());
+}
+
+
+ConstSpan<float> PointerSampleColumns::preciseY() const
+{
+    return ConstSpan<float>(_preciseY.data() + _begin, size());
+}
+
+
+ConstSpan<float> PointerSampleColumns::pressure() const
+{
+    return ConstSpan<float>(_pressure.data() + _begin, size());
+}
+
+
+ConstSpan<float> PointerSampleColumns::twistDeg() const
+{
+    return ConstSpan<float>(_twistDeg.data() + _begin, size());
+}
+
+
+ConstSpan<float> PointerSampleColumns::tiltXDeg() const
+{
+    return ConstSpan<float>(_tiltXDeg.data() + _begin, size());
+}
+
+
+ConstSpan<float> PointerSampleColumns::tiltYDeg() const
+{
+    return ConstSpan<float>(_tiltYDeg.data() + _begin, size());
+}
+
+
+ConstSpan<float> PointerSampleColumns::azimuthDeg() const
+{
+    return ConstSpan<float>(_azimuthDeg.data() + _begin, size());
+}
+
+
+ConstSpan<float> PointerSampleColumns::altitudeDeg() const
+{
+    return ConstSpan<float>(_altitudeDeg.data() + _begin, size());
+}
+
+
+ConstSpan<double> PointerSampleColumns::arcLength() const
+{
+    return ConstSpan<double>(_arcLength.data() + _begin, size());
+}
+
+
+ConstSpan<uint64_t> PointerSampleColumns::timestampMicros() const
+{
+    return ConstSpan<uint64_t>(_timestampMicros.data() + _begin, size());
+}
+
+
+ConstSpan<uint64_t> PointerSampleColumns::pointerId() const
+{
+    return ConstSpan<uint64_t>(_pointerId.data() + _begin, size());
+}
+
+
+ConstSpan<uint64_t> PointerSampleColumns::sequenceIndex() const
+{
+    return ConstSpan<uint64_t>(_sequenceIndex.data() + _begin, size());
+}
+
+
+ConstSpan<uint16_t> PointerSampleColumns::buttons() const
+{
+    return ConstSpan<uint16_t>(_buttons.data() + _begin, size());
+}
+
+
+ConstSpan<PointerEventArgs::EventKind> PointerSampleColumns::eventKind() const
+{
+    return ConstSpan<PointerEventArgs::EventKind>(_eventKind.data() + _begin, size());
+}
+
+
+ConstSpan<PointerEventArgs::DeviceKind> PointerSampleColumns::deviceKind() const
+{
+    return ConstSpan<PointerEventArgs::DeviceKind>(_deviceKind.data() + _begin, size());
+}
+
+
+ConstSpan<uint8_t> PointerSampleColumns::flags() const
+{
+    return ConstSpan<uint8_t>(_flags.data() + _begin, size());
+}
+
+
+ConstSpan<uint8_t> PointerSampleColumns::estimatedPropertyFlags() const
+{
+    return ConstSpan<uint8_t>(_estimatedPropertyFlags.data() + _begin, size());
+}
+
+
+ConstSpan<uint8_t> PointerSampleColumns::estimatedPropertyFlagsExpectingUpdates() const
+{
+    return ConstSpan<uint8_t>(_estimatedPropertyFlagsExpectingUpdates.data() + _begin, size());
+}
+
+
+void PointerSampleColumns::_updateAzimuthAltitude(std::size_t first)
+{
+    _azimuthDeg.resize(_timestampMicros.size());
+    _altitudeDeg.resize(_timestampMicros.size());
+
+    if (first >= size())
+        return;
+
+    std::size_t index = _begin + first;
+
+    Point::toAzimuthAltitudeDeg(_tiltXDeg.data() + index,
+                                _tiltYDeg.data() + index,
+                                _azimuthDeg.data() + index,
+                                _altitudeDeg.data() + index,
+                                size() - first);
+}
+
+
+void PointerSampleColumns::_updateArcLength(std::size_t first)
+{
+    // New samples start at zero, so an empty stroke starts at zero.
+    _arcLength.resize(_timestampMicros.size());
+
+    for (std::size_t i = _begin + std::max(first, std::size_t(1)); i < _arcLength.size(); ++i)
+    {
+        _arcLength[i] = _arcLength[i - 1] + double(glm::distance(glm::vec2(_x[i - 1], _y[i - 1]),
+                                                                 glm::vec2(_x[i], _y[i])));
+    }
+}
+
+
+void PointerSampleColumns::_copy(std::size_t to, std::size_t from)
+{
+    _x[to] = _x[from];
+    _y[to] = _y[from];
+    _preciseX[to] = _preciseX[from];
+    _preciseY[to] = _preciseY[from];
+    _pressure[to] = _pressure[from];
+    _twistDeg[to] = _twistDeg[from];
+    _tiltXDeg[to] = _tiltXDeg[from];
+    _tiltYDeg[to] = _tiltYDeg[from];
+    _azimuthDeg[to] = _azimuthDeg[from];
+    _altitudeDeg[to] = _altitudeDeg[from];
+    _arcLength[to] = _arcLength[from];
+    _timestampMicros[to] = _timestampMicros[from];
+    _pointerId[to] = _pointerId[from];
+    _sequenceIndex[to] = _sequenceIndex[from];
+    _buttons[to] = _buttons[from];
+    _eventKind[to] = _eventKind[from];
+    _deviceKind[to] = _deviceKind[from];
+    _flags[to] = _flags[from];
+    _estimatedPropertyFlags[to] = _estimatedPropertyFlags[from];
+    _estimatedPropertyFlagsExpectingUpdates[to] = _estimatedPropertyFlagsExpectingUpdates[from];
+}
+
+
+PointerSequenceIndexMap::PointerSequenceIndexMap()
+{
+}
+
+
+PointerSequenceIndexMap::~PointerSequenceIndexMap()
+{
+}
+
+
+void PointerSequenceIndexMap::reserve(std::size_t size)
+{
+    std::size_t numSlots = 16;
+
+    while (numSlots < 2 * size)
+        numSlots *= 2;
+
+    if (numSlots > _slots.size())
+        _rehash(numSlots);
+}
+
+
+const uint64_t* PointerSequenceIndexMap::find(uint64_t sequenceIndex) const
+{
+    if (_size == 0 || sequenceIndex == 0)
+        return nullptr;
+
+    const Slot& slot = _slots[_findSlot(sequenceIndex)];
+    return slot.sequenceIndex == sequenceIndex ? &slot.position : nullptr;
+}
+
+
+void PointerSequenceIndexMap::set(uint64_t sequenceIndex, uint64_t position)
+{
+    if (sequenceIndex == 0)
+        return;
+
+    if (2 * (_size + 1) > _slots.size())
+        reserve(_size + 1);
+
+    Slot& slot = _slots[_findSlot(sequenceIndex)];
+
+    if (slot.sequenceIndex == 0)
+    {
+        slot.sequenceIndex = sequenceIndex;
+        ++_size;
+    }
+
+    slot.position = position;
+}
+
+
+void PointerSequenceIndexMap::erase(uint64_t sequenceIndex)
+{
+    if (_size == 0 || sequenceIndex == 0)
+        return;
+
+    std::size_t slot = _findSlot(sequenceIndex);
+
+    if (_slots[slot].sequenceIndex == sequenceIndex)
+        _eraseSlot(slot);
+}
+
+
+void PointerSequenceIndexMap::erase(uint64_t sequenceIndex, uint64_t position)
+{
+    if (_size == 0 || sequenceIndex == 0)
+        return;
+
+    std::size_t slot = _findSlot(sequenceIndex);
+
+    if (_slots[slot].sequenceIndex == sequenceIndex && _slots[slot].position == position)
+        _eraseSlot(slot);
+}
+
+
+void PointerSequenceIndexMap::clear()
+{
+    std::fill(_slots.begin(), _slots.end(), Slot());
+    _size = 0;
+}
+
+
+std::size_t PointerSequenceIndexMap::size() const
+{
+    return _size;
+}
+
+
+bool PointerSequenceIndexMap::empty() const
+{
+    return _size == 0;
+}
+
+
+std::size_t PointerSequenceIndexMap::_findSlot(uint64_t sequenceIndex) const
+{
+    const std::size_t mask = _slots.size() - 1;
+
+    // Fibonacci hashing, as for the active pointer slots.
+    std::size_t slot = static_cast<std::size_t>((sequenceIndex * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+
+    while (_slots[slot].sequenceIndex != 0 && _slots[slot].sequenceIndex != sequenceIndex)
+        slot = (slot + 1) & mask;
+
+    return slot;
+}
+
+
+void PointerSequenceIndexMap::_eraseSlot(std::size_t slot)
+{
+    const std::size_t mask = _slots.size() - 1;
+
+    // Backward shift deletion keeps probe sequences intact without
+    // tombstones.
+    _slots[slot] = Slot();
+    --_size;
+    std::size_t next = slot;
+
+    for (;;)
+    {
+        next = (next + 1) & mask;
+
+        if (_slots[next].sequenceIndex == 0)
+            break;
+
+        std::size_t home = static_cast<std::size_t>((_slots[next].sequenceIndex * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+
+        // Move the entry if its home is not cyclically in (slot, next].
+        if (((next - home) & mask) >= ((next - slot) & mask))
+        {
+            _slots[slot] = _slots[next];
+            _slots[next] = Slot();
+            slot = next;
+        }
+    }
+}
+
+
+void PointerSequenceIndexMap::_rehash(std::size_t numSlots)
+{
+    std::vector<Slot> slots(numSlots);
+    std::swap(slots, _slots);
+
+    for (const auto& slot: slots)
+    {
+        if (slot.sequenceIndex != 0)
+            _slots[_findSlot(slot.sequenceIndex)] = slot;
+    }
+}
+
+
+PointerStrokeSimplifier::PointerStrokeSimplifier()
+{
+    _window.reserve(_settings.maxWindowSize);
+}
+
+
+PointerStrokeSimplifier::PointerStrokeSimplifier(const Settings& settings):
+    _settings(settings)
+{
+    _settings.maxWindowSize = std::max(_settings.maxWindowSize, std::size_t(1));
+    _window.reserve(_settings.maxWindowSize);
+}
+
+
+PointerStrokeSimplifier::~PointerStrokeSimplifier()
+{
+}
+
+
+void PointerStrokeSimplifier::add(const PointerSample& sample)
+{
+    ++_numAddedSamples;
+
+    if (_samples.empty())
+    {
+        _anchor = sample;
+        _samples.push_back(sample);
+        _indexSample(0);
+        return;
+    }
+
+    if (!_window.empty() && _canExtendWindow(sample))
+    {
+        // Replace the newest sample, which remains in the window.
+        std::size_t last = _samples.size() - 1;
+        _samplesExpectingUpdates.erase(_window.back().sequenceIndex, _numDroppedSamples + last);
+
+        _window.push_back(sample);
+        _samples.set(last, sample);
+        _indexSample(last);
+        return;
+    }
+
+    // Retain the newest sample and start a new window after it.
+    if (!_window.empty())
+    {
+        _anchor = _window.back();
+        _window.clear();
+    }
+
+    _window.push_back(sample);
+    _samples.push_back(sample);
+    _indexSample(_samples.size() - 1);
+}
+
+
+bool PointerStrokeSimplifier::update(const PointerEventArgs& e)
+{
+    bool foundIt = false;
+
+    const uint64_t* position = _samplesExpectingUpdates.find(e.sequenceIndex());
+
+    if (position)
+    {
+        std::size_t index = *position - _numDroppedSamples;
+        PointerSample sample = _samples[index];
+
+        if (sample.updateEstimatedPropertiesWithEvent(e))
+        {
+            _samples.set(index, sample);
+
+            if (sample.estimatedPropertyFlagsExpectingUpdates == PointerEventArgs::PROPERTY_FLAG_NONE)
+                _samplesExpectingUpdates.erase(e.sequenceIndex());
+        }
+
+        foundIt = true;
+    }
+
+    if (_anchor.sequenceIndex == e.sequenceIndex())
+        _anchor.updateEstimatedPropertiesWithEvent(e);
+
+    for (auto& sample: _window)
+    {
+        if (sample.sequenceIndex == e.sequenceIndex())
+        {
+            sample.updateEstimatedPropertiesWithEvent(e);
+            foundIt = true;
+        }
+    }
+
+    return foundIt;
+}
+
+
+void PointerStrokeSimplifier::dropBefore(uint64_t timestampMicros)
+{
+    const auto timestamps = _samples.timestampMicros();
+    std::size_t count = 0;
+
+    while (count + 1 < _samples.size() && timestamps[count] < timestampMicros)
+        ++count;
+
+    if (count == 0)
+        return;
+
+    const auto sequenceIndices = _samples.sequenceIndex();
+    const auto expectingUpdates = _samples.estimatedPropertyFlagsExpectingUpdates();
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (expectingUpdates[i] != PointerEventArgs::PROPERTY_FLAG_NONE)
+            _samplesExpectingUpdates.erase(sequenceIndices[i], _numDroppedSamples + i);
+    }
+
+    _samples.eraseFront(count);
+    _numDroppedSamples += count;
+}
+
+
+void PointerStrokeSimplifier::reserve(std::size_t size)
+{
+    // As in a bounded PointerStroke, erased front samples are kept until
+    // they outnumber the rest.
+    _samples.reserve(2 * size);
+    _samplesExpectingUpdates.reserve(size);
+}
+
+
+void PointerStrokeSimplifier::clear()
+{
+    _samples.clear();
+    _anchor = PointerSample();
+    _window.clear();
+    _samplesExpectingUpdates.clear();
+    _numAddedSamples = 0;
+    _numDroppedSamples = 0;
+}
+
+
+const PointerStrokeSimplifier::Settings& PointerStrokeSimplifier::settings() const
+{
+    return _settings;
+}
+
+
+const PointerSampleColumns& PointerStrokeSimplifier::samples() const
+{
+    return _samples;
+}
+
+
+uint64_t PointerStrokeSimplifier::numAddedSamples() const
+{
+    return _numAddedSamples;
+}
+
+
+bool PointerStrokeSimplifier::_canExtendWindow(const PointerSample& sample) const
+{
+    if (_window.size() >= _settings.maxWindowSize)
+        return false;
+
+    const glm::vec2 a = _anchor.position;
+    const glm::vec2 ab = sample.position - a;
+    const float lengthSquared = glm::dot(ab, ab);
+    const float toleranceSquared = _settings.tolerance * _settings.tolerance;
+
+    for (const auto& windowSample: _window)
+    {
+        const glm::vec2 ap = windowSample.position - a;
+
+        // The closest point on the segment from the anchor to the sample.
+        float t = 0;
+
+        if (lengthSquared > 0)
+            t = ofClamp(glm::dot(ap, ab) / lengthSquared, 0, 1);
+
+        if (glm::length2(ap - ab * t) > toleranceSquared)
+            return false;
+
+        float pressure = _anchor.pressure + (sample.pressure - _anchor.pressure) * t;
+
+        if (std::abs(windowSample.pressure - pressure) > _settings.pressureTolerance)
+            return false;
+    }
+
+    return true;
+}
+
+
+void PointerStrokeSimplifier::_indexSample(std::size_t index)
+{
+    const auto sequenceIndices = _samples.sequenceIndex();
+    const auto expectingUpdates = _samples.estimatedPropertyFlagsExpectingUpdates();
+
+    if (expectingUpdates[index] != PointerEventArgs::PROPERTY_FLAG_NONE && sequenceIndices[index] != 0)
+        _samplesExpectingUpdates.set(sequenceIndices[index], _numDroppedSamples + index);
+}
+
+
+PointerStrokeResampler::PointerStrokeResampler()
+{
+}
+
+
+PointerStrokeResampler::PointerStrokeResampler(const Settings& settings):
+    _settings(settings)
+{
+    if (!(_settings.spacing > 0))
+        _settings.spacing = Settings().spacing;
+
+    _samples.reserve(_settings.count);
+}
+
+
+PointerStrokeResampler::~PointerStrokeResampler()
+{
+}
+
+
+void PointerStrokeResampler::update(const PointerSampleColumns& samples,
+                                    std::size_t firstChangedIndex)
+{
+    if (samples.empty())
+    {
+        clear();
+        return;
+    }
+
+    const auto arcLengths = samples.arcLength();
+    const double firstArcLength = arcLengths.front();
+    const double lastArcLength = arcLengths.back();
+
+    std::size_t index = 0;
+
+    if (_settings.count > 0)
+    {
+        _samples.clear();
+
+        for (std::size_t i = 0; i < _settings.count; ++i)
+        {
+            double t = _settings.count > 1 ? double(i) / double(_settings.count - 1) : 0;
+            index = _push_back(samples, index, firstArcLength + (lastArcLength - firstArcLength) * t);
+        }
+
+        return;
+    }
+
+    const double spacing = _settings.spacing;
+
+    // Remove multiples before the first sample, which was erased from the front.
+    uint64_t firstMultiple = uint64_t(std::ceil(firstArcLength / spacing));
+
+    if (firstMultiple > _firstMultiple)
+    {
+        _samples.eraseFront(std::min(uint64_t(_samples.size()), firstMultiple - _firstMultiple));
+        _firstMultiple = firstMultiple;
+    }
+
+    // Remove multiples at or after the last unchanged sample.
+    firstChangedIndex = std::min(firstChangedIndex, samples.size());
+
+    if (firstChangedIndex == 0)
+        _samples.clear();
+    else
+    {
+        uint64_t changedMultiple = uint64_t(std::ceil(arcLengths[firstChangedIndex - 1] / spacing));
+
+        if (changedMultiple < _firstMultiple + _samples.size())
+            _samples.truncate(changedMultiple > _firstMultiple ? changedMultiple - _firstMultiple : 0);
+    }
+
+    if (_samples.empty())
+        _firstMultiple = firstMultiple;
+
+    // Start the search for each multiple at the last unchanged sample.
+    if (!_samples.empty())
+        index = firstChangedIndex - 1;
+
+    for (uint64_t multiple = _firstMultiple + _samples.size(); multiple * spacing <= lastArcLength; ++multiple)
+        index = _push_back(samples, index, multiple * spacing);
 }
 
 
-PointerEvents* PointerEventsManager::events()
+void PointerStrokeResampler::clear()
 {
-    return eventsForWindow(nullptr);
+    _samples.clear();
+    _firstMultiple = 0;
 }
 
 
-PointerEvents* PointerEventsManager::eventsForWindow(ofAppBaseWindow* window)
+const PointerStrokeResampler::Settings& PointerStrokeResampler::settings() const
 {
-    auto iter = _windowEventMap.find(window);
+    return _settings;
+}
 
-    if (iter != _windowEventMap.end())
-    {
-        return iter->second.get();
-    }
 
-    _windowEventMap[window] = std::make_unique<PointerEvents>(window);
-    return _windowEventMap[window].get();
+const PointerSampleColumns& PointerStrokeResampler::samples() const
+{
+    return _samples;
 }
 
 
-PointerEventsManager& PointerEventsManager::instance()
+std::size_t PointerStrokeResampler::_push_back(const PointerSampleColumns& samples,
+                                               std::size_t index,
+                                               double arcLength)
 {
-    static PointerEventsManager instance;
-    return instance;
+    const auto arcLengths = samples.arcLength();
+
+    // Find the last sample at or before the arc length.
+    auto iter = std::upper_bound(arcLengths.begin() + index,
+                                 arcLengths.end(),
+                                 arcLength);
+
+    if (iter != arcLengths.begin() + index)
+        index = std::size_t(iter - arcLengths.begin()) - 1;
+
+    PointerSample sample = samples[index];
+
+    if (index + 1 < samples.size())
+    {
+        const PointerSample next = samples[index + 1];
+
+        double segmentLength = arcLengths[index + 1] - arcLengths[index];
+        float t = 0;
+
+        if (segmentLength > 0)
+            t = ofClamp(float((arcLength - arcLengths[index]) / segmentLength), 0, 1);
+
+        sample.position += (next.position - sample.position) * t;
+        sample.precisePosition += (next.precisePosition - sample.precisePosition) * t;
+        sample.pressure += (next.pressure - sample.pressure) * t;
+        sample.twistDeg += (next.twistDeg - sample.twistDeg) * t;
+        sample.tiltXDeg += (next.tiltXDeg - sample.tiltXDeg) * t;
+        sample.tiltYDeg += (next.tiltYDeg - sample.tiltYDeg) * t;
+        sample.timestampMicros = uint64_t(double(sample.timestampMicros)
+                                        + (double(next.timestampMicros) - double(sample.timestampMicros)) * t);
+    }
+
+    _samples.push_back(sample);
+
+    return index;
 }
 
 
-PointerEventsManager::PointerEventsManager()
+const float PointerStroke::DEFAULT_MAX_SAMPLE_RATE_HZ = 1000;
+
+
+PointerStroke::PointerStroke()
 {
 }
 
 
-PointerEventsManager::~PointerEventsManager()
+PointerStroke::PointerStroke(std::size_t capacity, uint64_t windowMicros):
+    _capacity(std::max(capacity, std::size_t(1))),
+    _windowMicros(windowMicros)
 {
+    // Dropped samples are skipped until they outnumber the rest, so the
+    // columns never hold more than twice the capacity.
+    _samples.reserve(2 * _capacity);
+    _samplesExpectingUpdates.reserve(_capacity);
 }
 
 
-
-PointerStroke::PointerStroke()
+PointerStroke::~PointerStroke()
 {
 }
 
 
-PointerStroke::~PointerStroke()
+std::size_t PointerStroke::capacityForWindow(uint64_t windowMicros,
+                                             float maxSampleRateHz)
 {
+    return std::size_t(std::ceil(double(windowMicros) * maxSampleRateHz / 1000000.0)) + 1;
 }
 
 
 bool PointerStroke::add(const PointerEventArgs& e)
 {
-    if (_events.empty())
+    if (_samples.empty())
         _pointerId = e.pointerId();
 
     if (_pointerId != e.pointerId())
         return false;
 
-    if (e.eventType() == PointerEventArgs::POINTER_UPDATE)
+    if (e.eventKind() == PointerEventArgs::EventKind::POINTER_UPDATE)
     {
-        auto riter = _events.rbegin();
-        while (riter != _events.rend())
+        bool foundIt = _hasSimplifier && _simplifier.update(e);
+
+        const uint64_t* position = _samplesExpectingUpdates.find(e.sequenceIndex());
+
+        if (!position)
+            return foundIt;
+
+        std::size_t index = *position - _numDroppedSamples;
+
+        PointerSample sample = _samples[index];
+
+        if (!sample.updateEstimatedPropertiesWithEvent(e))
         {
-            if (riter->sequenceIndex() == e.sequenceIndex())
-            {
-                if (!riter->updateEstimatedPropertiesWithEvent(e))
-                    ofLogError("PointerStroke::add") << "Error updating matching property.";
-                return true;
-            }
-            ++riter;
+            ofLogError("PointerStroke::add") << "Error updating matching property.";
+            return true;
         }
 
-        return false;
+        _samples.set(index, sample);
+
+        if (_hasResampler)
+            _resampler.update(_samples, index);
+
+        if (sample.estimatedPropertyFlagsExpectingUpdates == PointerEventArgs::PROPERTY_FLAG_NONE)
+            _samplesExpectingUpdates.erase(e.sequenceIndex());
+
+        return true;
     }
 
-    // Remove predicted events.
-    _events.erase(std::remove_if(_events.begin(),
-                                 _events.end(),
-                                [](const PointerEventArgs& x) { return x.isPredicted(); }),
-                 _events.end());
+    // Replace the predicted tail. Committed samples are never touched.
+    _samples.truncate(_committedSize);
+
+    // The stroke position of the first new sample.
+    uint64_t firstChangedPosition = _numDroppedSamples + _committedSize;
 
     // Add coalesced events, this includes the current event.
     auto coalesced = e.coalescedPointerEvents();
-    _events.insert(_events.end(), coalesced.begin(), coalesced.end());
+    auto predicted = e.predictedPointerEvents();
+
+    if (_capacity > 0)
+    {
+        // Keep the newest coalesced and the nearest predicted samples.
+        if (coalesced.size() > _capacity)
+        {
+            coalesced = ConstSpan<PointerEventArgs>(coalesced.end() - _capacity,
+                                                    _capacity);
+        }
+
+        if (predicted.size() > _capacity - coalesced.size())
+        {
+            predicted = ConstSpan<PointerEventArgs>(predicted.data(),
+                                                    _capacity - coalesced.size());
+        }
+
+        std::size_t size = _committedSize + coalesced.size() + predicted.size();
+
+        if (size > _capacity)
+            _dropFront(size - _capacity);
+    }
+
+    _samples.append(coalesced);
+
+    // Index the new committed samples that are expecting updates.
+    const auto sequenceIndices = _samples.sequenceIndex();
+    const auto expectingUpdates = _samples.estimatedPropertyFlagsExpectingUpdates();
+
+    for (std::size_t i = _committedSize; i < _samples.size(); ++i)
+    {
+        if (expectingUpdates[i] != PointerEventArgs::PROPERTY_FLAG_NONE && sequenceIndices[i] != 0)
+            _samplesExpectingUpdates.set(sequenceIndices[i], _numDroppedSamples + i);
+
+        if (_hasSimplifier)
+            _simplifier.add(_samples[i]);
+    }
+
+    _committedSize = _samples.size();
+
+    if (_windowMicros > 0 && _committedSize > 0)
+    {
+        const auto timestamps = _samples.timestampMicros();
+        uint64_t newestTimestampMicros = timestamps[_committedSize - 1];
+        std::size_t count = 0;
+
+        while (count + 1 < _committedSize
+           && newestTimestampMicros - timestamps[count] > _windowMicros)
+        {
+            ++count;
+        }
+
+        _dropFront(count);
+    }
+
+    // Keep the simplified samples within the remaining stroke.
+    if (_hasSimplifier && _numDroppedSamples > 0 && _committedSize > 0)
+        _simplifier.dropBefore(_samples.timestampMicros().front());
 
     if (coalesced.empty())
         ofLogError("PointerStroke::add") << "No coalesced events!";
 
     // Add predicted events.
-    auto predicted = e.predictedPointerEvents();
-    _events.insert(_events.end(), predicted.begin(), predicted.end());
+    _samples.append(predicted);
+
+    if (_hasResampler)
+    {
+        _resampler.update(_samples, firstChangedPosition > _numDroppedSamples
+                                  ? std::size_t(firstChangedPosition - _numDroppedSamples)
+                                  : 0);
+    }
 
     _minSequenceIndex = std::min(e.sequenceIndex(), _minSequenceIndex);
     _maxSequenceIndex = std::max(e.sequenceIndex(), _maxSequenceIndex);
@@ -1133,6 +4806,27 @@ bool PointerStroke::add(const PointerEventArgs& e)
 }
 
 
+void PointerStroke::_dropFront(std::size_t count)
+{
+    if (count == 0)
+        return;
+
+    const auto sequenceIndices = _samples.sequenceIndex();
+    const auto expectingUpdates = _samples.estimatedPropertyFlagsExpectingUpdates();
+
+    // Dropped samples can no longer be updated.
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (expectingUpdates[i] != PointerEventArgs::PROPERTY_FLAG_NONE)
+            _samplesExpectingUpdates.erase(sequenceIndices[i], _numDroppedSamples + i);
+    }
+
+    _samples.eraseFront(count);
+    _committedSize -= count;
+    _numDroppedSamples += count;
+}
+
+
 std::size_t PointerStroke::pointerId() const
 {
     return _pointerId;
@@ -1153,67 +4847,204 @@ uint64_t PointerStroke::maxSequenceIndex() const
 
 uint64_t PointerStroke::minTimestampMicros() const
 {
-    if (_events.empty())
+    if (_samples.empty())
         return 0;
 
-    return _events.front().timestampMicros();
+    return _samples.timestampMicros().front();
 }
 
 
 uint64_t PointerStroke::maxTimestampMicros() const
 {
-    if (_events.empty())
+    if (_samples.empty())
         return 0;
 
-    return _events.back().timestampMicros();
+    return _samples.timestampMicros().back();
+}
+
+
+ofRectangle PointerStroke::axisAlignedBounds() const
+{
+    if (_samples.empty())
+        return ofRectangle();
+
+    float minX = 0;
+    float maxX = 0;
+    float minY = 0;
+    float maxY = 0;
+
+    const auto x = _samples.x();
+    const auto y = _samples.y();
+
+    toMinMax(x.data(), x.size(), minX, maxX);
+    toMinMax(y.data(), y.size(), minY, maxY);
+
+    return ofRectangle(minX, minY, maxX - minX, maxY - minY);
 }
 
 
 bool PointerStroke::isFinished() const
 {
-    return !_events.empty() && (_events.back().eventType() == PointerEventArgs::POINTER_CANCEL
-                             || _events.back().eventType() == PointerEventArgs::POINTER_UP);
+    if (_committedSize == 0)
+        return false;
+
+    auto eventKind = _samples.eventKind()[_committedSize - 1];
+    return eventKind == PointerEventArgs::EventKind::POINTER_CANCEL
+        || eventKind == PointerEventArgs::EventKind::POINTER_UP;
 }
 
 
 bool PointerStroke::isCancelled() const
 {
-    return !_events.empty() && _events.back().eventType() == PointerEventArgs::POINTER_CANCEL;
+    return _committedSize > 0
+        && _samples.eventKind()[_committedSize - 1] == PointerEventArgs::EventKind::POINTER_CANCEL;
 }
 
 
 bool PointerStroke::isExpectingUpdates() const
 {
-    // Start at the end, because newer events are likely the ones with estimated
-    // properties.
-    auto riter = _events.rbegin();
-    while (riter != _events.rend())
-    {
-        if (!riter->estimatedProperties().empty())
-            return true;
+    return !_samplesExpectingUpdates.empty();
+}
 
-        ++riter;
-    }
 
-    return false;
+std::size_t PointerStroke::numSamplesExpectingUpdates() const
+{
+    return _samplesExpectingUpdates.size();
 }
 
 
 std::size_t PointerStroke::size() const
 {
-    return _events.size();
+    return _samples.size();
 }
 
 
 bool PointerStroke::empty() const
 {
-    return _events.empty();
+    return _samples.empty();
 }
 
 
-const std::vector<PointerEventArgs>& PointerStroke::events() const
+std::size_t PointerStroke::committedSize() const
 {
-    return _events;
+    return _committedSize;
+}
+
+
+std::size_t PointerStroke::predictedSize() const
+{
+    return _samples.size() - _committedSize;
+}
+
+
+bool PointerStroke::isBounded() const
+{
+    return _capacity > 0;
+}
+
+
+std::size_t PointerStroke::capacity() const
+{
+    return _capacity;
+}
+
+
+uint64_t PointerStroke::windowMicros() const
+{
+    return _windowMicros;
+}
+
+
+uint64_t PointerStroke::numDroppedSamples() const
+{
+    return _numDroppedSamples;
+}
+
+
+void PointerStroke::attachSimplifier(const PointerStrokeSimplifier::Settings& settings)
+{
+    _simplifier = PointerStrokeSimplifier(settings);
+    _hasSimplifier = true;
+
+    if (_capacity > 0)
+        _simplifier.reserve(_capacity);
+
+    for (std::size_t i = 0; i < _committedSize; ++i)
+        _simplifier.add(_samples[i]);
+}
+
+
+void PointerStroke::detachSimplifier()
+{
+    _simplifier = PointerStrokeSimplifier();
+    _hasSimplifier = false;
+}
+
+
+bool PointerStroke::hasSimplifier() const
+{
+    return _hasSimplifier;
+}
+
+
+const PointerStrokeSimplifier& PointerStroke::simplifier() const
+{
+    return _simplifier;
+}
+
+
+void PointerStroke::attachResampler(const PointerStrokeResampler::Settings& settings)
+{
+    _resampler = PointerStrokeResampler(settings);
+    _hasResampler = true;
+    _resampler.update(_samples, 0);
+}
+
+
+void PointerStroke::detachResampler()
+{
+    _resampler = PointerStrokeResampler();
+    _hasResampler = false;
+}
+
+
+bool PointerStroke::hasResampler() const
+{
+    return _hasResampler;
+}
+
+
+const PointerStrokeResampler& PointerStroke::resampler() const
+{
+    return _resampler;
+}
+
+
+float PointerStroke::length() const
+{
+    if (_committedSize == 0)
+        return 0;
+
+    const auto arcLengths = _samples.arcLength();
+    return float(arcLengths[_committedSize - 1] - arcLengths.front());
+}
+
+
+const PointerSampleColumns& PointerStroke::samples() const
+{
+    return _samples;
+}
+
+
+std::vector<PointerEventArgs> PointerStroke::events() const
+{
+    std::vector<PointerEventArgs> results;
+    results.reserve(_samples.size());
+
+    for (auto sample: _samples)
+        results.push_back(PointerEventArgs::toPointerEventArgs(nullptr, sample));
+
+    return results;
 }
 
 
@@ -1249,32 +5080,35 @@ void PointerDebugRenderer::setup(const Settings& settings)
 
 void PointerDebugRenderer::update()
 {
-    if (!_strokes.empty())
-    {
-        auto now = ofGetElapsedTimeMillis();
+    uint64_t now = EventArgs::nowMicros() / 1000;
 
-        // Avoid rollover by subtracting from an unsigned now.
-        if (now < _settings.timeoutMillis)
-            return;
+    // Avoid rollover by subtracting from an unsigned now.
+    if (now < _settings.timeoutMillis)
+        return;
 
-        auto lastValidTime = now - _settings.timeoutMillis;
+    auto lastValidTime = now - _settings.timeoutMillis;
 
-        auto iter = _strokes.begin();
+    auto removeTimedOut = [&](std::vector<PointerStroke>& strokes) {
+        strokes.erase(std::remove_if(strokes.begin(),
+                                     strokes.end(),
+                                     [&](const PointerStroke& x)
+                                     { return lastValidTime > x.maxTimestampMicros() / 1000; }),
+                      strokes.end());
+    };
 
-        while (iter != _strokes.end())
-        {
-            if (iter->second.empty())
-                iter = _strokes.erase(iter);
-            else
-            {
-                iter->second.erase(std::remove_if(iter->second.begin(),
-                                                  iter->second.end(),
-                                                  [&](const PointerStroke& x)
-                                                  { return lastValidTime > x.events().back().timestampMillis(); }),
-                                    iter->second.end());
-                ++iter;
-            }
-        }
+    for (auto& strokes: _strokes)
+        removeTimedOut(strokes);
+
+    auto iter = _overflowStrokes.begin();
+
+    while (iter != _overflowStrokes.end())
+    {
+        removeTimedOut(iter->second);
+
+        if (iter->second.empty())
+            iter = _overflowStrokes.erase(iter);
+        else
+            ++iter;
     }
 }
 
@@ -1282,6 +5116,10 @@ void PointerDebugRenderer::update()
 void PointerDebugRenderer::draw() const
 {
     for (auto& strokes: _strokes)
+        for (auto& stroke: strokes)
+            draw(stroke);
+
+    for (auto& strokes: _overflowStrokes)
         for (auto& stroke: strokes.second)
             draw(stroke);
 }
@@ -1289,7 +5127,7 @@ void PointerDebugRenderer::draw() const
 
 void PointerDebugRenderer::draw(const PointerStroke& stroke) const
 {
-    auto nowMillis = ofGetElapsedTimeMillis();
+    uint64_t nowMillis = EventArgs::nowMicros() / 1000;
 
     auto lastValidTimeMillis = nowMillis - _settings.timeoutMillis;
 
@@ -1303,18 +5141,23 @@ void PointerDebugRenderer::draw(const PointerStroke& stroke) const
     float R = _settings.strokeWidth;
     auto fadeTimeMillis = std::min(uint64_t(50), _settings.timeoutMillis);
 
-    const auto& events = stroke.events();
+    const auto& samples = stroke.samples();
+    const auto x = samples.x();
+    const auto y = samples.y();
+    const auto azimuthsDeg = samples.azimuthDeg();
+    const auto altitudesDeg = samples.altitudeDeg();
+    const auto pressures = samples.pressure();
+    const auto timestampsMicros = samples.timestampMicros();
+    const auto flags = samples.flags();
 
-    for (std::size_t i = 0; i < events.size(); ++i)
+    for (std::size_t i = 0; i < samples.size(); ++i)
     {
-        const auto& e = events[i];
-
         // Pen tip.
-        glm::vec3 p0 = { e.position().x, e.position().y, 0 };
+        glm::vec3 p0 = { x[i], y[i], 0 };
         glm::vec3 p1 = p0;
 
-        float az = e.point().azimuthRad();
-        float al = e.point().altitudeRad();
+        float az = glm::radians(azimuthsDeg[i]);
+        float al = glm::radians(altitudesDeg[i]);
 
         if (!ofIsFloatEqual(az, 0.0f) || !ofIsFloatEqual(al, 0.0f))
         {
@@ -1328,14 +5171,14 @@ void PointerDebugRenderer::draw(const PointerStroke& stroke) const
         else
         {
             // If no altitude / azimuth are available, use tangents to simulate.
-            if (i > 0 && i < events.size() - 1)
+            if (i > 0 && i < samples.size() - 1)
             {
                 std::size_t i1 = i - 1;
                 std::size_t i2 = i;
                 std::size_t i3 = i + 1;
-                const auto& p_1 = events[i1].position();
-                const auto& p_2 = events[i2].position();
-                const auto& p_3 = events[i3].position();
+                glm::vec2 p_1 = { x[i1], y[i1] };
+                glm::vec2 p_2 = { x[i2], y[i2] };
+                glm::vec2 p_3 = { x[i3], y[i3] };
                 auto v1(p_1 - p_2); // vector to previous point
                 auto v2(p_3 - p_2); // vector to next point
                 v1 = glm::normalize(v1);
@@ -1351,18 +5194,18 @@ void PointerDebugRenderer::draw(const PointerStroke& stroke) const
 
         // Here we combine the age of the line and the pressure to fade out
         // the line via an opacity change.
-        float pressure = e.point().pressure();
+        float pressure = pressures[i];
 
-        double timeRemainingMillis = double(e.timestampMillis()) - double(lastValidTimeMillis);
+        double timeRemainingMillis = double(timestampsMicros[i] / 1000) - double(lastValidTimeMillis);
         float fader = ofMap(timeRemainingMillis, fadeTimeMillis, 0, 1, 0, true);
         float pressureFader = pressure * fader;
 
         ofColor c0, c1;
 
         // Here we color the points based on the point type.
-        if (e.isCoalesced())
+        if (flags[i] & PointerSample::FLAG_COALESCED)
             c0 = c1 = ofColor(_settings.coalescedPointColor, pressureFader * 255);
-        else if (e.isPredicted())
+        else if (flags[i] & PointerSample::FLAG_PREDICTED)
             c0 = c1 = ofColor(_settings.predictedPointColor);
         else
             c0 = c1 = ofColor(_settings.pointColor, pressureFader * 255);
@@ -1377,7 +5220,7 @@ void PointerDebugRenderer::draw(const PointerStroke& stroke) const
 }
 
 
-PointerDebugRenderer::Settings PointerDebugRenderer::settings() const
+const PointerDebugRenderer::Settings& PointerDebugRenderer::settings() const
 {
     return _settings;
 }
@@ -1385,31 +5228,30 @@ PointerDebugRenderer::Settings PointerDebugRenderer::settings() const
 
 void PointerDebugRenderer::clear()
 {
-    _strokes.clear();
+    for (auto& strokes: _strokes)
+        strokes.clear();
+
+    _overflowStrokes.clear();
 }
 
 
 void PointerDebugRenderer::add(const PointerEventArgs& e)
 {
     // Ignore mouse just rolling around.
-    if (e.deviceType() == PointerEventArgs::TYPE_MOUSE
-    && e.eventType() == PointerEventArgs::POINTER_MOVE
+    if (e.deviceKind() == PointerEventArgs::DeviceKind::MOUSE
+    && e.eventKind() == PointerEventArgs::EventKind::POINTER_MOVE
     && e.buttons() == 0)
         return;
 
-    auto strokesIter = _strokes.find(e.pointerId());
-
-    if (e.eventType() == PointerEventArgs::POINTER_UPDATE)
+    if (e.eventKind() == PointerEventArgs::EventKind::POINTER_UPDATE)
     {
         bool foundIt = false;
-        if (strokesIter != _strokes.end())
+
+        for (auto& stroke: strokesForPointerId(e.pointerId()))
         {
-            for (auto& stroke: strokesIter->second)
-            {
-                foundIt = stroke.add(e);
-                if (foundIt)
-                    break;
-            }
+            foundIt = stroke.add(e);
+            if (foundIt)
+                break;
         }
 
         if (!foundIt)
@@ -1419,19 +5261,23 @@ void PointerDebugRenderer::add(const PointerEventArgs& e)
     }
 
     // Process all events.
-    if (strokesIter == _strokes.end())
-    {
-        bool result;
-        std::tie(strokesIter, result) = _strokes.insert(std::make_pair(e.pointerId(), std::vector<PointerStroke>()));
-    }
+    auto& strokes = _strokesForPointerId(e.pointerId());
 
-    if (strokesIter->second.empty() || strokesIter->second.back().isFinished())
+    if (strokes.empty() || strokes.back().isFinished())
     {
-        strokesIter->second.push_back(PointerStroke());
+        if (_settings.maxStrokeSamples > 0)
+        {
+            strokes.push_back(PointerStroke(_settings.maxStrokeSamples,
+                                            _settings.timeoutMillis * 1000));
+        }
+        else
+        {
+            strokes.push_back(PointerStroke());
+        }
     }
 
     // Get a reference to the current stroke.
-    auto& stroke = strokesIter->second.back();
+    auto& stroke = strokes.back();
 
     if (!stroke.add(e))
     {
@@ -1440,9 +5286,40 @@ void PointerDebugRenderer::add(const PointerEventArgs& e)
 }
 
 
-const std::map<std::size_t, std::vector<PointerStroke>>& PointerDebugRenderer::strokes() const
+const std::vector<PointerStroke>& PointerDebugRenderer::strokesForPointerId(std::size_t pointerId) const
+{
+    static const std::vector<PointerStroke> noStrokes;
+
+    if (pointerId < PointerEvents::MAX_ACTIVE_POINTERS)
+        return _strokes[pointerId];
+
+    auto iter = _overflowStrokes.find(pointerId);
+    return iter != _overflowStrokes.end() ? iter->second : noStrokes;
+}
+
+
+std::map<std::size_t, std::vector<PointerStroke>> PointerDebugRenderer::strokes() const
+{
+    std::map<std::size_t, std::vector<PointerStroke>> strokes = _overflowStrokes;
+
+    for (std::size_t i = 0; i < PointerEvents::MAX_ACTIVE_POINTERS; ++i)
+    {
+        if (!_strokes[i].empty())
+            strokes[i] = _strokes[i];
+    }
+
+    return strokes;
+}
+
+
+std::vector<PointerStroke>& PointerDebugRenderer::_strokesForPointerId(std::size_t pointerId)
 {
-    return _strokes;
+    // Small ids index the array directly. Source ids of pointers that did
+    // not fit in the active pointer table can be any value.
+    if (pointerId < PointerEvents::MAX_ACTIVE_POINTERS)
+        return _strokes[pointerId];
+
+    return _overflowStrokes[pointerId];
 }
 
 
@@ -1471,49 +5348,74 @@ bool PointerEventCollection::empty() const
 void PointerEventCollection::clear()
 {
     _events.clear();
-    _eventsForPointerId.clear();
+
+    for (auto& eventIndices: _eventIndices)
+        eventIndices.clear();
+
+    _overflowEventIndices.clear();
+    _numPointers = 0;
 }
 
 
 std::size_t PointerEventCollection::numPointers() const
 {
-    return _eventsForPointerId.size();
+    return _numPointers;
 }
 
 
 bool PointerEventCollection::hasPointerId(std::size_t pointerId)
 {
-    return _eventsForPointerId.find(pointerId) != _eventsForPointerId.end();
+    return _findEventIndices(pointerId) != nullptr;
 }
 
 
 void PointerEventCollection::add(const PointerEventArgs& pointerEvent)
 {
-    _events.push_back(pointerEvent);
+    std::size_t pointerId = pointerEvent.pointerId();
 
-    auto iter = _eventsForPointerId.find(pointerEvent.pointerId());
+    // Small ids index the array directly. Source ids of pointers that did
+    // not fit in the active pointer table can be any value.
+    auto& eventIndices = pointerId < PointerEvents::MAX_ACTIVE_POINTERS
+                       ? _eventIndices[pointerId]
+                       : _overflowEventIndices[pointerId];
 
-    if (iter != _eventsForPointerId.end())
-        iter->second.push_back(&_events.back());
-    else
-        _eventsForPointerId[pointerEvent.pointerId()] = { &_events.back() };
+    if (eventIndices.empty())
+        ++_numPointers;
 
+    // Indices stay valid when _events reallocates.
+    eventIndices.push_back(_events.size());
+    _events.push_back(pointerEvent);
 }
 
 
 void PointerEventCollection::removeEventsForPointerId(std::size_t pointerId)
 {
-    _eventsForPointerId.erase(pointerId);
+    if (!_findEventIndices(pointerId))
+        return;
+
+    _events.erase(std::remove_if(_events.begin(),
+                                 _events.end(),
+                                 [&](const PointerEventArgs& e)
+                                 { return e.pointerId() == pointerId; }),
+                  _events.end());
 
-    auto iter = _events.begin();
+    // The remaining events moved, so index them again.
+    for (auto& eventIndices: _eventIndices)
+        eventIndices.clear();
 
-    while (iter != _events.end())
+    _overflowEventIndices.clear();
+
+    for (std::size_t i = 0; i < _events.size(); ++i)
     {
-        if (iter->pointerId() == pointerId)
-            iter = _events.erase(iter);
+        std::size_t id = _events[i].pointerId();
+
+        if (id < PointerEvents::MAX_ACTIVE_POINTERS)
+            _eventIndices[id].push_back(i);
         else
-            ++iter;
+            _overflowEventIndices[id].push_back(i);
     }
+
+    --_numPointers;
 }
 
 
@@ -1527,12 +5429,10 @@ std::vector<PointerEventArgs> PointerEventCollection::eventsForPointerId(std::si
 {
     std::vector<PointerEventArgs> results;
 
-    auto iter = _eventsForPointerId.find(pointerId);
-
-    if (iter != _eventsForPointerId.end())
+    if (const auto* eventIndices = _findEventIndices(pointerId))
     {
-        for (auto* event: iter->second)
-            results.push_back(*event);
+        for (std::size_t index: *eventIndices)
+            results.push_back(_events[index]);
     }
 
     return results;
@@ -1541,12 +5441,8 @@ std::vector<PointerEventArgs> PointerEventCollection::eventsForPointerId(std::si
 
 const PointerEventArgs* PointerEventCollection::firstEventForPointerId(std::size_t pointerId) const
 {
-    auto iter = _eventsForPointerId.find(pointerId);
-
-    if (iter != _eventsForPointerId.end())
-    {
-        return iter->second.front();
-    }
+    if (const auto* eventIndices = _findEventIndices(pointerId))
+        return &_events[eventIndices->front()];
 
     return nullptr;
 }
@@ -1554,15 +5450,21 @@ const PointerEventArgs* PointerEventCollection::firstEventForPointerId(std::size
 
 const PointerEventArgs* PointerEventCollection::lastEventForPointerId(std::size_t pointerId) const
 {
-    auto iter = _eventsForPointerId.find(pointerId);
-
-    if (iter != _eventsForPointerId.end())
-    {
-        return iter->second.back();
-    }
+    if (const auto* eventIndices = _findEventIndices(pointerId))
+        return &_events[eventIndices->back()];
 
     return nullptr;
 }
 
 
+const std::vector<std::size_t>* PointerEventCollection::_findEventIndices(std::size_t pointerId) const
+{
+    if (pointerId < PointerEvents::MAX_ACTIVE_POINTERS)
+        return _eventIndices[pointerId].empty() ? nullptr : &_eventIndices[pointerId];
+
+    auto iter = _overflowEventIndices.find(pointerId);
+    return iter != _overflowEventIndices.end() ? &iter->second : nullptr;
+}
+
+
 } // namespace ofx
@@ -14,43 +14,41 @@
 #include "ofx/PointerEventsiOS.h"
 #include "ofx/PointerEvents.h"
 #include "ofMath.h"
+#include <cmath>
 
 
 using namespace ofx;
 
 
-UITouchProperties toUITouchProperties(const std::set<std::string>& properties)
+UITouchProperties toUITouchProperties(uint16_t propertyFlags)
 {
     UITouchProperties result = 0;
 
-    for (const auto& property: properties)
-    {
-        if (property == PointerEventArgs::PROPERTY_PRESSURE)
-            result &= UITouchPropertyForce;
-        else if (property == PointerEventArgs::PROPERTY_TILT_X || property == PointerEventArgs::PROPERTY_TILT_Y)
-            result &= (UITouchPropertyAzimuth & UITouchPropertyAltitude);
-        else if (property == PointerEventArgs::PROPERTY_POSITION)
-            result &= UITouchPropertyLocation;
-        else
-            ofLogWarning("toUITouchProperties") << "Unknown UITouchProperty: " << property;
-    }
+    if (propertyFlags & PointerEventArgs::PROPERTY_FLAG_PRESSURE)
+        result |= UITouchPropertyForce;
+
+    if (propertyFlags & (PointerEventArgs::PROPERTY_FLAG_TILT_X | PointerEventArgs::PROPERTY_FLAG_TILT_Y))
+        result |= (UITouchPropertyAzimuth | UITouchPropertyAltitude);
+
+    if (propertyFlags & PointerEventArgs::PROPERTY_FLAG_POSITION)
+        result |= UITouchPropertyLocation;
 
     return result;
 }
 
 
-std::set<std::string> toPopertySet(UITouchProperties properties)
+uint16_t toPropertyFlags(UITouchProperties properties)
 {
-    std::set<std::string> result;
+    uint16_t result = PointerEventArgs::PROPERTY_FLAG_NONE;
 
     if (properties & UITouchPropertyForce)
-        result.insert(PointerEventArgs::PROPERTY_PRESSURE);
+        result |= PointerEventArgs::PROPERTY_FLAG_PRESSURE;
 
     if (properties & UITouchPropertyAzimuth || properties & UITouchPropertyAltitude)
-        result.insert({ PointerEventArgs::PROPERTY_TILT_X, PointerEventArgs::PROPERTY_TILT_Y });
+        result |= (PointerEventArgs::PROPERTY_FLAG_TILT_X | PointerEventArgs::PROPERTY_FLAG_TILT_Y);
 
     if (properties & UITouchPropertyLocation)
-        result.insert(PointerEventArgs::PROPERTY_POSITION);
+        result |= PointerEventArgs::PROPERTY_FLAG_POSITION;
 
     return result;
 }
@@ -64,41 +62,16 @@ bool dispatchPointerEvent(ofAppBaseWindow* window, PointerEventArgs& e)
 
     if (events)
     {
-        // All pointer events get dispatched via pointerEvent.
-        consumed = ofNotifyEvent(events->pointerEvent, e, window);
-
-        // If the pointer was not consumed, then send it along to the standard five.
-        if (!consumed)
-        {
-            if (e.eventType() == PointerEventArgs::POINTER_DOWN)
-            {
-                consumed = ofNotifyEvent(events->pointerDown, e, window);
-            }
-            else if (e.eventType() == PointerEventArgs::POINTER_UP)
-            {
-                consumed = ofNotifyEvent(events->pointerUp, e, window);
-            }
-            else if (e.eventType() == PointerEventArgs::POINTER_MOVE)
-            {
-                consumed = ofNotifyEvent(events->pointerMove, e, window);
-            }
-            else if (e.eventType() == PointerEventArgs::POINTER_CANCEL)
-            {
-                consumed = ofNotifyEvent(events->pointerCancel, e, window);
-            }
-            else if (e.eventType() == PointerEventArgs::POINTER_UPDATE)
-            {
-                consumed = ofNotifyEvent(events->pointerUpdate, e, window);
-            }
-        }
+        // Dispatch like any other source, so that pointer ids, isPrimary,
+        // pointer capture, filtered events and frame batching all apply.
+        consumed = events->onPointerEvent(window, e);
     }
     else
     {
         ofLogError("PointerViewIOS::touchesEnded") << "Invalid event, passing.";
     }
 
-    // TODO address consumeLegacy events.
-    return /*events->consumeLegacyEvents ||*/ consumed;
+    return consumed;
 }
 
 
@@ -125,10 +98,6 @@ bool dispatchPointerEvent(ofAppBaseWindow* window, PointerEventArgs& e)
             _viewEAGL = [ofxiOSEAGLView getInstance];
     }
 
-    _startTimeSeconds = [[NSProcessInfo processInfo] systemUptime];
-
-    [self resetTouches];
-
     return self;
 }
 
@@ -138,27 +107,6 @@ bool dispatchPointerEvent(ofAppBaseWindow* window, PointerEventArgs& e)
 }
 
 
--(void) resetTouches
-{
-    _activePointerIndices[UITouchTypeDirect] = {};
-    _activePointerIndices[UITouchTypeIndirect] = {};
-#if defined(__IPHONE_9_1)
-    _activePointerIndices[UITouchTypeStylus] = {};
-#endif
-    _primaryPointerIndices[UITouchTypeDirect] = -1;
-    _primaryPointerIndices[UITouchTypeIndirect] = -1;
-#if defined(__IPHONE_9_1)
-    _primaryPointerIndices[UITouchTypeStylus] = -1;
-#endif
-}
-
-
-- (void)willMoveToSuperview:(UIView *)newSuperview;
-{
-    [self resetTouches];
-}
-
-
 - (void)touchesBegan:(NSSet<UITouch *> *)touches withEvent:(UIEvent *)event
 {
     ofx::PointerEvents* events = ofx::PointerEventsManager::instance().events();
@@ -329,14 +277,14 @@ bool dispatchPointerEvent(ofAppBaseWindow* window, PointerEventArgs& e)
 
     uint64_t buttons = 0;
 
-    std::string eventType = PointerEventArgs::EVENT_TYPE_UNKNOWN;
+    PointerEventArgs::EventKind eventKind = PointerEventArgs::EventKind::UNKNOWN;
     uint64_t detail = 0;
 
     uint64_t sequenceIndex = [[touch estimationUpdateIndex] unsignedLongLongValue];
 
-    std::set<std::string> estimatedProperties = toPopertySet([touch estimatedProperties]);
+    uint16_t estimatedPropertyFlags = toPropertyFlags([touch estimatedProperties]);
 
-    std::set<std::string> estimatedPropertiesExpectingUpdates = toPopertySet([touch estimatedPropertiesExpectingUpdates]);
+    uint16_t estimatedPropertyFlagsExpectingUpdates = toPropertyFlags([touch estimatedPropertiesExpectingUpdates]);
 
     int64_t pointerIndex = _pointerIndex;
 
@@ -344,30 +292,25 @@ bool dispatchPointerEvent(ofAppBaseWindow* window, PointerEventArgs& e)
     {
         case UITouchPhaseBegan:
         {
-            eventType = PointerEventArgs::POINTER_DOWN;
+            eventKind = PointerEventArgs::EventKind::POINTER_DOWN;
             buttons |= (1 << OF_MOUSE_BUTTON_1);
-            if (_activePointerIndices[[touch type]].empty())
-                _primaryPointerIndices[[touch type]] = pointerIndex;
-            _activePointerIndices[[touch type]].insert(pointerIndex);
             break;
         }
         case UITouchPhaseMoved:
         case UITouchPhaseStationary:
         {
-            eventType = PointerEventArgs::POINTER_MOVE;
+            eventKind = PointerEventArgs::EventKind::POINTER_MOVE;
             buttons |= (1 << OF_MOUSE_BUTTON_1);
             break;
         }
         case UITouchPhaseEnded:
         {
-            eventType = PointerEventArgs::POINTER_UP;
-            _activePointerIndices[[touch type]].erase(pointerIndex);
+            eventKind = PointerEventArgs::EventKind::POINTER_UP;
             break;
         }
         case UITouchPhaseCancelled:
         {
-            eventType = PointerEventArgs::POINTER_CANCEL;
-            _activePointerIndices[[touch type]].erase(pointerIndex);
+            eventKind = PointerEventArgs::EventKind::POINTER_CANCEL;
             break;
         }
     }
@@ -375,7 +318,7 @@ bool dispatchPointerEvent(ofAppBaseWindow* window, PointerEventArgs& e)
     // If this is an update, we change its event type.
     if (_isUpdate)
     {
-        eventType = PointerEventArgs::POINTER_UPDATE;
+        eventKind = PointerEventArgs::EventKind::POINTER_UPDATE;
         // TODO ... this shouldn't happen.
         if ([touch estimatedPropertiesExpectingUpdates] > 0)
             assert(false);
@@ -399,26 +342,27 @@ bool dispatchPointerEvent(ofAppBaseWindow* window, PointerEventArgs& e)
 
     bool isPredicted = _isPredicted;
     bool isCoalesced = _isCoalesced;
-    bool isPrimary = (pointerIndex == _primaryPointerIndices[[touch type]]);
+    // PointerEvents assigns isPrimary from its active pointer table.
+    bool isPrimary = false;
 
-    std::string deviceType = PointerEventArgs::TYPE_UNKNOWN;
+    PointerEventArgs::DeviceKind deviceKind = PointerEventArgs::DeviceKind::UNKNOWN;
 
     switch ([touch type])
     {
         case UITouchTypeDirect:
         {
-            deviceType = PointerEventArgs::TYPE_TOUCH;
+            deviceKind = PointerEventArgs::DeviceKind::TOUCH;
             break;
         }
         case UITouchTypeIndirect:
         {
-            deviceType = PointerEventArgs::TYPE_MOUSE;
+            deviceKind = PointerEventArgs::DeviceKind::MOUSE;
             break;
         }
 #if defined(__IPHONE_9_1)
         case UITouchTypeStylus:
         {
-            deviceType = PointerEventArgs::TYPE_PEN;
+            deviceKind = PointerEventArgs::DeviceKind::PEN;
             // Azimuth angle. Valid only for stylus touch types. Zero radians points along the positive X axis.
             // Passing a nil for the view parameter will return the azimuth relative to the touch's window.
             CGFloat azimuthRad = [touch azimuthAngleInView:view];
@@ -466,10 +410,13 @@ bool dispatchPointerEvent(ofAppBaseWindow* window, PointerEventArgs& e)
     modifiers |= ofGetKeyPressed(OF_KEY_SHIFT)   ? OF_KEY_SHIFT   : 0;
     modifiers |= ofGetKeyPressed(OF_KEY_SUPER)   ? OF_KEY_SUPER   : 0;
 
-    // Convert seconds to milliseconds.
-    NSTimeInterval timestampSeconds = [touch timestamp];
-    NSTimeInterval elapsedTimestampSeconds = timestampSeconds - _startTimeSeconds;
-    uint64_t timestampMicros = elapsedTimestampSeconds * 1000000.0;
+    // Touch timestamps use the system uptime clock, so convert the offset of
+    // the touch from now to the event clock. Predicted touches lie in the
+    // future and have a positive offset.
+    NSTimeInterval offsetSeconds = [touch timestamp] - [[NSProcessInfo processInfo] systemUptime];
+    int64_t offsetMicros = std::llround(offsetSeconds * 1000000.0);
+    int64_t nowMicros = EventArgs::nowMicros();
+    uint64_t timestampMicros = std::max(nowMicros + offsetMicros, int64_t(0));
 
     std::size_t deviceId = 0;
     uint64_t button = 0;
@@ -508,13 +455,10 @@ bool dispatchPointerEvent(ofAppBaseWindow* window, PointerEventArgs& e)
 
     const void* eventSource = self->_window;
 
-    std::size_t pointerId = 0;
-    hash_combine(pointerId, deviceId);
-    hash_combine(pointerId, pointerIndex);
-    hash_combine(pointerId, deviceType);
+    std::size_t pointerId = PointerEventArgs::toSourcePointerId(deviceKind, deviceId, pointerIndex);
 
     return PointerEventArgs(eventSource,
-                            eventType,
+                            eventKind,
                             timestampMicros,
                             detail,
                             point,
@@ -522,7 +466,7 @@ bool dispatchPointerEvent(ofAppBaseWindow* window, PointerEventArgs& e)
                             deviceId,
                             pointerIndex,
                             sequenceIndex,
-                            deviceType,
+                            deviceKind,
                             isCoalesced,
                             isPredicted,
                             isPrimary,
@@ -531,8 +475,8 @@ bool dispatchPointerEvent(ofAppBaseWindow* window, PointerEventArgs& e)
                             modifiers,
                             coalescedPointerEvents,
                             predictedPointerEvents,
-                            estimatedProperties,
-                            estimatedPropertiesExpectingUpdates);
+                            estimatedPropertyFlags,
+                            estimatedPropertyFlagsExpectingUpdates);
 }
 
 - (CGPoint)orientateTouchPoint:(CGPoint)touchPoint